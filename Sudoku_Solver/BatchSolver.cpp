@@ -0,0 +1,568 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author : Ajinkya Joshi, Anthony Chamoun
+* Date : March 15, 2023
+* File name : BatchSolver.cpp - Multi-threaded batch solving
+* Purpose : Spreads puzzles over a work-stealing pool, reports in order
+****************************************************************************/
+
+#include "BatchSolver.h"
+#include "LockstepSolver.h"
+#ifdef SUDOKU_PROFILE
+#include "PerfCounters.h"
+#endif
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <unistd.h>
+
+using namespace std;
+
+// nodes searched between two checks of the backtrack and time budgets
+static const long BudgetSlice = 256;
+
+const int BatchSolver::WindowChunks;
+
+/**
+ * Puts a cached solution on a board, after checking that it keeps every given and breaks no unit; an entry
+ * from a stale or edited cache file must not pass off a wrong board as solved.
+ * @param board The board, holding the puzzle.
+ * @param canonical The cached solution of the canonical form, empty for a puzzle without one.
+ * @param symmetry The symmetry from the puzzle to its canonical form.
+ * @return True if the board now holds the solution, or the puzzle has none; false if the entry does not fit
+ *         and the board still holds the puzzle.
+*/
+static bool takeCached(SudokuBoard &board, const string &canonical, const BoardSymmetry &symmetry)
+{
+    if (canonical.empty())
+        return true;
+    string puzzle = board.toString();
+    string solution = board.fromCanonical(canonical, symmetry);
+    for (size_t i = 0; i < puzzle.size(); i++)
+        if (puzzle[i] != '.' && puzzle[i] != solution[i])
+            return false;
+    board.initializeBoard(solution);
+    if (board.isConsistent())
+        return true;
+    board.initializeBoard(puzzle);
+    return false;
+}
+
+/**
+ * Runs a search on a board in slices, checking the budget after every slice.
+ * @param board The board, holding the puzzle.
+ * @param limit The search stops after this many solutions.
+ * @param budget The limits; at least one of them is set.
+ * @param start When the search started.
+ * @param recur The number of recursive calls made during the search.
+ * @param backtrack The number of failed branches.
+ * @return True if the search finished, false if it gave up.
+*/
+static bool searchWithin(SudokuBoard &board, long limit, const SearchBudget &budget,
+                         chrono::steady_clock::time_point start, int &recur, int &backtrack)
+{
+    board.beginSearch(limit);
+    for (;;)
+    {
+        // the node budget is exact, the slice never goes past it
+        long slice = BudgetSlice;
+        if (budget.nodes > 0)
+        {
+            if (recur >= budget.nodes)
+                return false;
+            slice = min(slice, budget.nodes - recur);
+        }
+        if (board.continueSearch(slice, recur, backtrack))
+            return true;
+        if (budget.backtracks > 0 && backtrack >= budget.backtracks)
+            return false;
+        if (budget.nanos > 0 &&
+            chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count() >= budget.nanos)
+            return false;
+    }
+}
+
+/**************************************************************************
+ * Constructor / Destructor
+****************************************************************************/
+
+
+/**
+ * Starts the pool and gives every worker a board configured with the batch options.
+ * @param threads: Number of workers, 0 for one per hardware thread
+ * @param N: The size of the boards
+ * @param opts: Solver settings
+*/
+BatchSolver::BatchSolver(int threads, int N, SolverOptions opts) : boardSize(N), options(opts), pool(threads)
+{
+    for (int i = 0; i < pool.size(); i++)
+    {
+        SudokuBoard* board = new SudokuBoard(N);
+        board->setSelection(options.selection);
+        board->setPropagation(options.propagate);
+        boards.push_back(board);
+        if (options.useDlx)
+            links.push_back(new DancingLinks(N));
+        // lockstep only solves, one 9 x 9 puzzle per lane
+        if (options.lockstep && N == 9 && !options.useDlx && options.splitDepth == 0 && options.countLimit == 0)
+            groups.push_back(new LockstepSolver(options.selection, options.propagate, options.budget));
+    }
+}
+
+/**
+ * Frees the per-worker boards once the pool is idle.
+*/
+BatchSolver::~BatchSolver()
+{
+    pool.wait();
+    for (int i = 0; i < (int)boards.size(); i++)
+        delete boards[i];
+    for (int i = 0; i < (int)links.size(); i++)
+        delete links[i];
+    for (int i = 0; i < (int)groups.size(); i++)
+        delete groups[i];
+    for (int i = 0; i < (int)spareBoards.size(); i++)
+        delete spareBoards[i];
+}
+
+
+/**************************************************************************
+ * Solving
+****************************************************************************/
+
+/**
+ * Returns the number of worker threads.
+ * @return The number of workers.
+*/
+int BatchSolver::threadCount()
+{
+    return pool.size();
+}
+
+/**
+ * Loads a puzzle onto a board, solves it and records the outcome.
+ * @param board The board to solve on.
+ * @param dlx The exact cover solver, or NULL to use solveSudoku.
+ * @param puzzle The puzzle text.
+ * @param result Receives the outcome.
+ * @param pool When set, the search tree of the puzzle is split across this pool.
+ * @param splitDepth Levels expanded before splitting.
+*/
+void BatchSolver::solveOne(SudokuBoard &board, DancingLinks *dlx, const string &puzzle, PuzzleResult &result,
+                           ThreadPool *pool, int splitDepth)
+{
+    board.initializeBoard(puzzle);
+    solveBoard(board, dlx, result, pool, splitDepth);
+}
+
+/**
+ * Solves the puzzle already loaded on a board and records the outcome.
+ * @param board The board to solve on.
+ * @param dlx The exact cover solver, or NULL to use solveSudoku.
+ * @param result Receives the outcome.
+ * @param pool When set, the search tree of the puzzle is split across this pool.
+ * @param splitDepth Levels expanded before splitting.
+ * @param countLimit When positive, counts solutions up to this limit instead of stopping at the first.
+ * @param cache When set, a puzzle equal to a cached one up to symmetry takes the cached solution, mapped back
+ *              through the symmetry, and a searched puzzle is added.
+ * @param budget Limits after which the search of the board gives up.
+*/
+void BatchSolver::solveBoard(SudokuBoard &board, DancingLinks *dlx, PuzzleResult &result, ThreadPool *pool,
+                             int splitDepth, long countLimit, SolutionCache *cache, const SearchBudget &budget)
+{
+    result.recursiveCount = 0;
+    result.backtracksCount = 0;
+    result.solutions = -1;
+    result.cached = false;
+    result.gaveUp = false;
+    bool budgeted = budget.nodes > 0 || budget.backtracks > 0 || budget.nanos > 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    // a counted puzzle needs its own search, and a board too symmetric to canonicalize is not cached
+    BoardSymmetry symmetry;
+    string key = (cache != NULL && countLimit == 0) ? board.canonicalForm(symmetry) : string();
+    string cachedSolution;
+    if (!key.empty() && cache->lookup(key, cachedSolution) && takeCached(board, cachedSolution, symmetry))
+    {
+        // an unsolvable puzzle stays as it was loaded
+        result.cached = true;
+        result.recursiveCount = 1;
+        result.solved = !cachedSolution.empty();
+        result.nanos = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+        board.toString(result.solution);
+        result.propagation = PropagationStats();
+        result.profile = SearchProfile();
+        return;
+    }
+
+#ifdef SUDOKU_PROFILE
+    // counters belong to the thread that opens them, so every worker keeps its own
+    static thread_local PerfCounters counters;
+    counters.start();
+#endif
+    if (countLimit > 0)
+    {
+        if (dlx != NULL)
+            result.solutions = dlx->countSolutions(board, countLimit, result.recursiveCount, result.backtracksCount);
+        else if (budgeted)
+        {
+            // a count cut short still reports the solutions it found
+            result.gaveUp = !searchWithin(board, countLimit, budget, start, result.recursiveCount, result.backtracksCount);
+            result.solutions = board.solutionsFound();
+        }
+        else
+            result.solutions = board.countSolutions(countLimit, result.recursiveCount, result.backtracksCount);
+        result.solved = result.solutions > 0;
+    }
+    else if (dlx != NULL)
+        result.solved = dlx->solve(board, result.recursiveCount, result.backtracksCount);
+    else if (pool != NULL && splitDepth > 0)
+        result.solved = board.solveParallel(*pool, splitDepth, result.recursiveCount, result.backtracksCount);
+    else if (budgeted)
+    {
+        result.gaveUp = !searchWithin(board, 1, budget, start, result.recursiveCount, result.backtracksCount);
+        result.solved = !result.gaveUp && board.solutionsFound() > 0;
+    }
+    else
+        result.solved = board.solveSudoku(result.recursiveCount, result.backtracksCount);
+    result.nanos = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    result.profile = board.getSearchProfile();
+#ifdef SUDOKU_PROFILE
+    counters.stop(result.profile);
+#endif
+    board.toString(result.solution);
+    result.propagation = board.getPropagationStats();
+    if (!key.empty() && !result.gaveUp)
+        cache->insert(key, result.solved ? board.toCanonical(result.solution, symmetry) : string());
+}
+
+/**
+ * Takes a spare board, or makes one when every board is in use.
+ * @return A board with the batch settings.
+*/
+SudokuBoard* BatchSolver::acquireBoard()
+{
+    {
+        lock_guard<mutex> guard(spareLock);
+        if (!spareBoards.empty())
+        {
+            SudokuBoard* board = spareBoards.back();
+            spareBoards.pop_back();
+            return board;
+        }
+    }
+    SudokuBoard* board = new SudokuBoard(boardSize);
+    board->setSelection(options.selection);
+    board->setPropagation(options.propagate);
+    return board;
+}
+
+/**
+ * Keeps a board for the next split puzzle. There are never more spare boards than puzzles that were in
+ * flight at once.
+ * @param board The board.
+*/
+void BatchSolver::releaseBoard(SudokuBoard* board)
+{
+    lock_guard<mutex> guard(spareLock);
+    spareBoards.push_back(board);
+}
+
+/**
+ * Loads and solves one puzzle on the calling worker.
+ * @param load Puts the puzzle on the board it is given.
+ * @param result Receives the outcome.
+ * @param split Whether options.splitDepth applies.
+*/
+void BatchSolver::solveOnWorker(function<void(SudokuBoard &)> load, PuzzleResult &result, bool split)
+{
+    int worker = pool.workerIndex();
+    DancingLinks* dlx = options.useDlx ? links[worker] : NULL;
+    if (split && options.splitDepth > 0 && dlx == NULL)
+    {
+        // a worker waiting on its subtrees may start another puzzle, so it cannot reuse its own board
+        SudokuBoard* board = acquireBoard();
+        load(*board);
+        solveBoard(*board, NULL, result, &pool, options.splitDepth, options.countLimit, options.cache, options.budget);
+        releaseBoard(board);
+    }
+    else
+    {
+        load(*boards[worker]);
+        solveBoard(*boards[worker], dlx, result, NULL, 0, options.countLimit, options.cache, options.budget);
+    }
+}
+
+/**
+ * Submits one task per puzzle, then walks the results in input order, waiting for each in turn.
+ * @param puzzles The puzzles to solve.
+ * @param report Called on this thread with each index and result, in order.
+*/
+void BatchSolver::solveAll(const vector<string> &puzzles, function<void(int, PuzzleResult &)> report)
+{
+    int total = puzzles.size();
+    vector<PuzzleResult> results(total);
+    vector<char> done(total, 0);
+    mutex doneLock;
+    condition_variable doneCond;
+
+    for (int i = 0; i < total && groups.empty(); i++)
+    {
+        pool.submit([&, i]() {
+            solveOnWorker([&](SudokuBoard &board) { board.initializeBoard(puzzles[i]); }, results[i]);
+
+            lock_guard<mutex> guard(doneLock);
+            done[i] = 1;
+            doneCond.notify_all();
+        });
+    }
+    // in lockstep a task solves a whole group of consecutive puzzles
+    for (int i = 0; i < total && !groups.empty(); i += LockstepSolver::Lanes)
+    {
+        pool.submit([&, i]() {
+            int count = min(LockstepSolver::Lanes, total - i);
+            groups[pool.workerIndex()]->solve(&puzzles[i], count, &results[i]);
+
+            lock_guard<mutex> guard(doneLock);
+            for (int k = i; k < i + count; k++)
+                done[k] = 1;
+            doneCond.notify_all();
+        });
+    }
+
+    for (int i = 0; i < total; i++)
+    {
+        {
+            unique_lock<mutex> guard(doneLock);
+            doneCond.wait(guard, [&] { return done[i] != 0; });
+        }
+        report(i, results[i]);
+    }
+    pool.wait();
+}
+
+/**
+ * Submits one task per range of ClaimChunk puzzles. Each task claims its range from the file and loads
+ * the puzzles straight from the mapping onto the worker's board. Results go to a ring of window slots,
+ * puzzle i to slot i modulo window, and the tasks are only submitted as the slots they will fill are
+ * reported, so no worker ever waits for room. The window is a whole number of ranges and every range starts
+ * at a multiple of ClaimChunk, so a range never wraps around the ring.
+ * @param file The opened puzzle file.
+ * @param report Called on this thread with each index and result, in order.
+*/
+void BatchSolver::solveAll(PuzzleFile &file, function<void(int, PuzzleResult &)> report)
+{
+    int total = file.size();
+    int window = max(WindowChunks, 4 * pool.size()) * ClaimChunk;
+    vector<PuzzleResult> results(min(window, total));
+    vector<char> done(results.size(), 0);
+    mutex doneLock;
+    condition_variable doneCond;
+
+    auto task = [&]() {
+        int first, last;
+        if (!file.claim(ClaimChunk, first, last))
+            return;
+        // in lockstep the range is copied out and solved a group at a time
+        for (int i = first; i < last && !groups.empty(); i += LockstepSolver::Lanes)
+        {
+            string texts[LockstepSolver::Lanes];
+            int count = min(LockstepSolver::Lanes, last - i);
+            for (int k = 0; k < count; k++)
+                texts[k] = file.text(i + k);
+            groups[pool.workerIndex()]->solve(texts, count, &results[i % window]);
+
+            lock_guard<mutex> guard(doneLock);
+            for (int k = i; k < i + count; k++)
+                done[k % window] = 1;
+            doneCond.notify_all();
+        }
+        for (int i = first; i < last && groups.empty(); i++)
+        {
+            solveOnWorker([&](SudokuBoard &board) { file.load(i, board); }, results[i % window]);
+
+            lock_guard<mutex> guard(doneLock);
+            done[i % window] = 1;
+            doneCond.notify_all();
+        }
+    };
+
+    file.rewind();
+    int submitted = 0; // puzzles covered by the tasks submitted so far
+    for (int i = 0; i < total; i++)
+    {
+        // keep the ring full: a range is only handed out once every slot it fills has been reported
+        for (; submitted < total && submitted + ClaimChunk <= i + window; submitted += ClaimChunk)
+            pool.submit(task);
+        {
+            unique_lock<mutex> guard(doneLock);
+            doneCond.wait(guard, [&] { return done[i % window] != 0; });
+            done[i % window] = 0;
+        }
+        report(i, results[i % window]);
+    }
+    pool.wait();
+}
+
+/**
+ * Queues one puzzle on the pool; the worker that takes it solves it on its own board and calls done.
+ * @param puzzle The puzzle text.
+ * @param done Called on the worker with the result.
+*/
+void BatchSolver::submit(const string &puzzle, function<void(PuzzleResult &)> done)
+{
+    pool.submit([this, puzzle, done]() {
+        PuzzleResult result;
+        solveOnWorker([&](SudokuBoard &board) { board.initializeBoard(puzzle); }, result);
+        done(result);
+    });
+}
+
+/**
+ * Three stages joined by a ring of window slots: a reader thread parses lines into the ring, one task per
+ * worker claims the parsed slots and solves them, and this thread reports the solved slots in order and hands
+ * them back to the reader. Slot n holds puzzle n modulo window. The stages pass slots through atomic counters
+ * and slot states, and only take the lock to sleep when there is nothing to do after a short spin.
+ * @param fd The descriptor to read.
+ * @param report Called on this thread with each index, puzzle text and result.
+ * @param window The number of slots.
+ * @return The number of puzzles.
+*/
+long long BatchSolver::solveStream(int fd, function<void(long long, const string &, PuzzleResult &)> report,
+                                   int window)
+{
+    struct Slot
+    {
+        string puzzle;
+        PuzzleResult result;
+        atomic<bool> solved{false};
+    };
+    vector<Slot> slots(max(window, 1));
+    long long size = slots.size();
+    atomic<long long> parsed(0); // puzzles put in the ring
+    atomic<long long> claimed(0); // puzzles taken by a worker
+    atomic<long long> reported(0); // puzzles handed back to the reader
+    atomic<bool> ended(false); // the reader has put in the last puzzle
+    bool overlong = false; // the reader stopped at a line longer than MaxLineLength
+
+    // a stage that ran out of work sleeps on its condition until another stage moves a counter
+    mutex sleepLock;
+    condition_variable readerCond, workerCond, writerCond;
+    atomic<int> sleepers(0);
+    auto wake = [&](condition_variable &cond) {
+        if (sleepers.load() > 0)
+        {
+            lock_guard<mutex> guard(sleepLock);
+            cond.notify_all();
+        }
+    };
+    auto waitFor = [&](condition_variable &cond, function<bool()> ready) {
+        for (int i = 0; i < SpinChecks; i++)
+        {
+            if (ready())
+                return;
+            this_thread::yield();
+        }
+        sleepers++;
+        {
+            unique_lock<mutex> guard(sleepLock);
+            cond.wait(guard, ready);
+        }
+        sleepers--;
+    };
+
+    // parser stage: puzzle lines as in PuzzleFile, '#' lines and short lines skipped
+    thread reader([&]() {
+        int cells = boardSize * boardSize;
+        string pending;
+        char chunk[65536];
+        bool more = true;
+        while (more)
+        {
+            ssize_t n = ::read(fd, chunk, sizeof(chunk));
+            more = n > 0;
+            if (more)
+                pending.append(chunk, n);
+            else if (!pending.empty())
+                pending += '\n';
+
+            size_t pos = 0;
+            const char* end;
+            while ((end = (const char*)memchr(pending.data() + pos, '\n', pending.size() - pos)) != NULL)
+            {
+                size_t lineEnd = end - pending.data();
+                while (pos < lineEnd && isspace((unsigned char)pending[pos]))
+                    pos++;
+                if (lineEnd - pos >= (size_t)cells && pending[pos] != '#')
+                {
+                    // backpressure: wait for the writer to free the slot
+                    long long index = parsed.load();
+                    waitFor(readerCond, [&] { return index - reported.load() < size; });
+                    slots[index % size].puzzle.assign(pending, pos, cells);
+                    parsed.store(index + 1);
+                    wake(workerCond);
+                }
+                pos = lineEnd + 1;
+            }
+            pending.erase(0, pos);
+
+            // a line that never ends would otherwise be held whole
+            if (pending.size() > (size_t)MaxLineLength)
+            {
+                overlong = true;
+                more = false;
+            }
+        }
+        ended.store(true);
+        wake(workerCond);
+        wake(writerCond);
+    });
+
+    // solver stage: every worker claims the next parsed slot until the input is over
+    for (int w = 0; w < pool.size(); w++)
+    {
+        pool.submit([&]() {
+            for (;;)
+            {
+                long long index = claimed.load();
+                if (index >= parsed.load())
+                {
+                    if (ended.load() && index >= parsed.load())
+                        return;
+                    waitFor(workerCond, [&] { return claimed.load() < parsed.load() || ended.load(); });
+                    continue;
+                }
+                if (!claimed.compare_exchange_weak(index, index + 1))
+                    continue;
+
+                Slot &slot = slots[index % size];
+                // never split: every other worker is in this loop too, so no one would take the leaves
+                solveOnWorker([&](SudokuBoard &board) { board.initializeBoard(slot.puzzle); }, slot.result, false);
+                slot.solved.store(true);
+                wake(writerCond);
+            }
+        });
+    }
+
+    // writer stage: report in input order and give the slot back to the reader
+    long long index = 0;
+    for (;; index++)
+    {
+        Slot &slot = slots[index % size];
+        waitFor(writerCond, [&] { return slot.solved.load() || (ended.load() && index >= parsed.load()); });
+        if (!slot.solved.load())
+            break;
+        report(index, slot.puzzle, slot.result);
+        slot.solved.store(false);
+        reported.store(index + 1);
+        wake(readerCond);
+    }
+    reader.join();
+    wake(workerCond);
+    pool.wait();
+    return overlong ? -1 : index;
+}
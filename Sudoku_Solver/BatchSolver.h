@@ -0,0 +1,201 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author          :Ajinkya Joshi, Anthony Chamoun
+* Date            :March 15th, 2023
+* File name       :BatchSolver.h
+* Purpose         :Solves a list of puzzles on a thread pool and hands the
+*                  results back in input order.
+ **************************************************************************/
+
+#ifndef BATCHSOLVER_H
+#define BATCHSOLVER_H
+#include <vector>
+#include <string>
+#include <functional>
+#include <mutex>
+#include "SudokuBoard.h"
+#include "DancingLinks.h"
+#include "ThreadPool.h"
+#include "PuzzleFile.h"
+#include "SolutionCache.h"
+
+using namespace std;
+
+class LockstepSolver;
+
+/**
+* Limits on the search of one puzzle, after which it gives up. 0 means no limit. Nodes are counted exactly;
+* backtracks and time are checked every few hundred nodes, so they may run slightly over.
+*/
+struct SearchBudget
+{
+    long nodes = 0; // recursive calls, including the initial call
+    long backtracks = 0;
+    long long nanos = 0; // wall time of the search
+};
+
+/**
+* Outcome of solving one puzzle.
+*/
+struct PuzzleResult
+{
+    bool solved = false;
+    int recursiveCount = 0; // recursive calls, including the initial call
+    int backtracksCount = 0;
+    string solution; // board after solving, in SudokuBoard::toString format
+    PropagationStats propagation;
+    long long nanos = 0; // wall time of the search, without loading the puzzle
+    long solutions = -1; // solutions found when counting, at most the limit; -1 when only solving
+    bool cached = false; // the solution came from the SolutionCache instead of a search
+    bool gaveUp = false; // the budget ran out first: no answer either way, the counters cover the partial search
+    SearchProfile profile; // phase times and hardware counters, when built with SUDOKU_PROFILE
+};
+
+/**
+* Settings shared by every board of a batch.
+*/
+struct SolverOptions
+{
+    SelectionOrder selection = FirstEmpty;
+    bool propagate = false;
+    bool useDlx = false;
+    int splitDepth = 0; // levels expanded before a single puzzle is split across the pool, 0 = no split
+    long countLimit = 0; // count solutions up to this many instead of solving, 0 = solve; never split
+    bool lockstep = false; // solve 9 x 9 puzzles in vectorized groups; ignored with useDlx, splitDepth or countLimit
+    SolutionCache* cache = NULL; // solutions shared by puzzles equal up to symmetry; not used when counting or in lockstep
+    SearchBudget budget; // limits of every search; not applied with useDlx or splitDepth
+};
+
+class BatchSolver
+{
+
+/*
+ * Every worker of the pool gets its own SudokuBoard (and DancingLinks when requested), so puzzles never
+ * share mutable state. Results are stored by input index and reported strictly in that order.
+*/
+private:
+    int boardSize;
+    SolverOptions options;
+    ThreadPool pool;
+    vector<SudokuBoard*> boards; // one board per worker
+    vector<DancingLinks*> links; // one exact cover matrix per worker, empty unless useDlx
+    vector<LockstepSolver*> groups; // one lockstep solver per worker, empty unless lockstep applies
+    vector<SudokuBoard*> spareBoards; // boards for split puzzles, kept for the next one instead of freed
+    mutex spareLock; // guards spareBoards
+
+    static const int ClaimChunk = 64; // puzzles a task claims from a PuzzleFile at once
+    static const int SpinChecks = 200; // checks a stream stage makes before it goes to sleep
+    static const int WindowChunks = 64; // ClaimChunk ranges of a PuzzleFile held at once, at least 4 per worker
+    static const int MaxLineLength = 1 << 16; // longest line solveStream holds while waiting for its newline
+
+    /**
+    * Takes a board for a puzzle split across the pool, reusing one a finished split puzzle gave back.
+    * @return A board with the batch settings.
+    */
+    SudokuBoard* acquireBoard();
+
+    /**
+    * Gives a board taken with acquireBoard back for the next split puzzle.
+    * @param board The board.
+    */
+    void releaseBoard(SudokuBoard* board);
+
+    /**
+    * Solves one puzzle on the calling worker's board, or on a pooled board of its own when splitting.
+    * @param load Puts the puzzle on the board it is given.
+    * @param result Receives the outcome.
+    * @param split Whether options.splitDepth applies; off where every worker is held by a long task.
+    */
+    void solveOnWorker(function<void(SudokuBoard &)> load, PuzzleResult &result, bool split = true);
+
+public:
+
+    /**
+    * Creates the pool and the per-worker boards.
+    * @param threads Number of workers, 0 for one per hardware thread.
+    * @param N The size of the boards.
+    * @param opts Solver settings applied to every board.
+    */
+    BatchSolver(int threads, int N, SolverOptions opts);
+
+    /**
+    * Frees the per-worker boards.
+    */
+    ~BatchSolver();
+
+    /**
+    * Returns the number of worker threads.
+    * @return The number of workers.
+    */
+    int threadCount();
+
+    /**
+    * Solves every puzzle and reports the results in input order. report is called on the calling thread
+    * as soon as the result for the next puzzle in order is ready, while later puzzles are still solving.
+    * @param puzzles The puzzles, in SudokuBoard::toString format.
+    * @param report Called once per puzzle with its index and result.
+    */
+    void solveAll(const vector<string> &puzzles, function<void(int, PuzzleResult &)> report);
+
+    /**
+    * Solves every puzzle of a mapped file and reports the results in file order, as the vector version does.
+    * Workers claim ranges of puzzle indices from the file and parse them directly from the mapping. Only a
+    * window of results is held, so memory does not grow with the number of puzzles in the file.
+    * @param file The opened file; its claim cursor is rewound first.
+    * @param report Called once per puzzle with its index and result.
+    */
+    void solveAll(PuzzleFile &file, function<void(int, PuzzleResult &)> report);
+
+    /**
+    * Solves puzzles read from a descriptor, e.g. stdin or a pipe, until it ends, and reports them in input
+    * order while later ones are still being read and solved. One puzzle per line, as in the one-line file
+    * format. At most window puzzles are held at any time, so memory stays constant however long the input
+    * is; the reader waits whenever the window is full. Lockstep groups are not used, and neither is splitDepth:
+    * the stream keeps every worker busy, so a split puzzle would never get help.
+    * @param fd The descriptor to read.
+    * @param report Called on this thread with each index, puzzle text and result.
+    * @param window The most puzzles read and not yet reported.
+    * @return The number of puzzles solved, or -1 when a line ran past MaxLineLength; reading stops there and
+    *         the puzzles before it are still reported.
+    */
+    long long solveStream(int fd, function<void(long long, const string &, PuzzleResult &)> report,
+                          int window = 4096);
+
+    /**
+    * Solves one puzzle on a worker without waiting for it, for callers that receive puzzles one at a time.
+    * Lockstep groups are not used.
+    * @param puzzle The puzzle text.
+    * @param done Called on the worker with the result.
+    */
+    void submit(const string &puzzle, function<void(PuzzleResult &)> done);
+
+    /**
+    * Loads and solves one puzzle on the given board.
+    * @param board The board to solve on.
+    * @param dlx The exact cover solver to use, or NULL for solveSudoku.
+    * @param puzzle The puzzle text.
+    * @param result Receives the outcome.
+    * @param pool When not NULL (and dlx is NULL) the puzzle itself is split across this pool.
+    * @param splitDepth Levels expanded before splitting, used with pool.
+    */
+    static void solveOne(SudokuBoard &board, DancingLinks *dlx, const string &puzzle, PuzzleResult &result,
+                         ThreadPool *pool = NULL, int splitDepth = 0);
+
+    /**
+    * Solves the puzzle already loaded on the given board.
+    * @param board The board to solve on.
+    * @param dlx The exact cover solver to use, or NULL for solveSudoku.
+    * @param result Receives the outcome.
+    * @param pool When not NULL (and dlx is NULL) the puzzle itself is split across this pool.
+    * @param splitDepth Levels expanded before splitting, used with pool.
+    * @param countLimit When positive, solutions are counted up to this limit instead, without splitting.
+    * @param cache When not NULL (and countLimit is 0) the solution is looked up by canonical form first and
+    *              remembered after a search.
+    * @param budget Limits after which solveSudoku or countSolutions gives up; not applied with dlx or pool.
+    */
+    static void solveBoard(SudokuBoard &board, DancingLinks *dlx, PuzzleResult &result,
+                           ThreadPool *pool = NULL, int splitDepth = 0, long countLimit = 0,
+                           SolutionCache *cache = NULL, const SearchBudget &budget = SearchBudget());
+};
+
+#endif
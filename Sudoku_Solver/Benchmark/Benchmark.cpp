@@ -0,0 +1,537 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author : Ajinkya Joshi, Anthony Chamoun
+* Date : March 15, 2023
+* File name : Benchmark.cpp - Solver benchmark
+* Purpose : Times solver configurations over fixed corpora and reports
+*           latency percentiles and throughput side by side
+* Usage : (from Sudoku_Solver/Benchmark)
+*         g++ -O2 -pthread -I.. Benchmark.cpp ../[A-Z][a-z]*.cpp -o benchmark
+*         ./benchmark [--corpus 96|easy|hard|17|FILE]... [--config NAME]... [--count N]
+*                     [--repeat R] [--seed S] [--records FILE]
+****************************************************************************/
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include "SudokuBoard.h"
+#include "DancingLinks.h"
+#include "BatchSolver.h"
+#include "PuzzleFile.h"
+#include "OutputWriter.h"
+#include "LockstepSolver.h"
+
+using namespace std;
+
+/**
+ * A named list of 9 x 9 puzzles in SudokuBoard::toString format.
+*/
+struct Corpus
+{
+    string name;
+    vector<string> puzzles;
+};
+
+/**
+ * A named solver configuration.
+*/
+struct Config
+{
+    string name;
+    SolverOptions options;
+    bool cache = false; // every pass starts with an empty SolutionCache
+};
+
+/**
+ * Measurements of one configuration over one corpus.
+*/
+struct Measurement
+{
+    vector<long long> nanos; // best solve time of each puzzle
+    vector<long long> nodes; // recursive calls of each puzzle
+    vector<long long> backtracks; // backtracks of each puzzle
+    vector<char> solved;
+    long long wallNanos = 0; // fastest full pass over the corpus, loading included
+};
+
+// Well-known puzzles with a unique solution that take the most search: Arto Inkala's 2012 puzzle,
+// AI Escargot and Easter Monster
+static const char* HardSeeds[] = {
+    "800000000003600000070090200050007000000045700000100030001000068008500010090000400",
+    "1....7.9..3..2...8..96..5....53..9...1..8...26....4...3......1..4......7..7...3..",
+    "1.......2.9.4...5...6...7...5.9.3.......7.......85..4.7.....6...3...9.8...2.....1"
+};
+
+// Puzzles with 17 clues, the fewest a 9 x 9 puzzle with a unique solution can have
+static const char* SeventeenSeeds[] = {
+    "000000010400000000020000000000050407008000300001090000300400200050100000000806000",
+    "000000012000035000000600070700000300000400800100000000000120000080000040050000600",
+    "000000012003600000000007000410020000000500300700000600280000040000300500000000000",
+    "000000012040050000000009000070600400000100000000000050000087500601000300200000000",
+    "000000013000030080070000000000206000030000900000010000600500204000400700100000000"
+};
+
+/**
+ * Returns a uniformly chosen integer below n. Uses the raw generator output rather than a standard
+ * distribution, whose algorithm differs between libraries, so a seed gives the same corpus everywhere.
+ * @param rng the generator
+ * @param n the number of choices
+ * @return a value from 0 to n - 1
+*/
+static int pick(mt19937 &rng, int n)
+{
+    return rng() % n;
+}
+
+/**
+ * Shuffles the first n entries of an array with the generator.
+ * @param values the array
+ * @param n the number of entries
+ * @param rng the generator
+*/
+static void shuffle(int* values, int n, mt19937 &rng)
+{
+    for (int i = n - 1; i > 0; i--)
+        swap(values[i], values[pick(rng, i + 1)]);
+}
+
+/**
+ * Applies a random validity-preserving symmetry to a 9 x 9 puzzle: relabels the digits, permutes the bands,
+ * the rows within each band, the stacks and the columns within each stack, and transposes half the time.
+ * The clue count, the number of solutions and the logical difficulty are unchanged.
+ * @param puzzle the puzzle
+ * @param rng the generator
+ * @return the transformed puzzle
+*/
+static string transform(const string &puzzle, mt19937 &rng)
+{
+    int digits[9], bands[3], stacks[3], rows[9], cols[9];
+    for (int i = 0; i < 9; i++)
+        digits[i] = i + 1;
+    shuffle(digits, 9, rng);
+
+    for (int i = 0; i < 3; i++)
+        bands[i] = stacks[i] = i;
+    shuffle(bands, 3, rng);
+    shuffle(stacks, 3, rng);
+    for (int b = 0; b < 3; b++)
+    {
+        int inner[3] = {0, 1, 2};
+        shuffle(inner, 3, rng);
+        for (int k = 0; k < 3; k++)
+            rows[b * 3 + k] = bands[b] * 3 + inner[k];
+        shuffle(inner, 3, rng);
+        for (int k = 0; k < 3; k++)
+            cols[b * 3 + k] = stacks[b] * 3 + inner[k];
+    }
+    bool transpose = pick(rng, 2) == 1;
+
+    string result(81, '.');
+    for (int r = 0; r < 9; r++)
+    {
+        for (int c = 0; c < 9; c++)
+        {
+            int from = transpose ? cols[c] * 9 + rows[r] : rows[r] * 9 + cols[c];
+            int digit = SudokuBoard::symbolToDigit(puzzle[from], 9);
+            if (digit != Blank)
+                result[r * 9 + c] = SudokuBoard::digitToSymbol(digits[digit - 1]);
+        }
+    }
+    return result;
+}
+
+/**
+ * Builds a corpus of symmetric variants of the given seed puzzles.
+ * @param name the corpus name
+ * @param seeds the seed puzzles
+ * @param seedCount the number of seeds
+ * @param count the number of puzzles to build
+ * @param rng the generator
+ * @return the corpus
+*/
+static Corpus variants(const string &name, const char* const* seeds, int seedCount, int count, mt19937 &rng)
+{
+    Corpus corpus;
+    corpus.name = name;
+    for (int i = 0; i < count; i++)
+        corpus.puzzles.push_back(transform(seeds[i % seedCount], rng));
+    return corpus;
+}
+
+/**
+ * Builds easy puzzles: random solved grids with cells removed in random order for as long as the
+ * solution stays unique, stopping at a fixed clue count.
+ * @param solutions solved grids to start from
+ * @param count the number of puzzles to build
+ * @param rng the generator
+ * @return the corpus
+*/
+static Corpus easyPuzzles(const vector<string> &solutions, int count, mt19937 &rng)
+{
+    const int Clues = 40;
+    Corpus corpus;
+    corpus.name = "easy";
+    SudokuBoard board(9);
+    DancingLinks dlx(9);
+
+    for (int i = 0; i < count; i++)
+    {
+        string puzzle = transform(solutions[i % solutions.size()], rng);
+        int order[81];
+        for (int k = 0; k < 81; k++)
+            order[k] = k;
+        shuffle(order, 81, rng);
+
+        int clues = 81;
+        for (int k = 0; k < 81 && clues > Clues; k++)
+        {
+            char kept = puzzle[order[k]];
+            puzzle[order[k]] = '.';
+            board.initializeBoard(puzzle);
+            int recur = 0, backtrack = 0;
+            if (dlx.countSolutions(board, 2, recur, backtrack) == 1)
+                clues--;
+            else
+                puzzle[order[k]] = kept;
+        }
+        corpus.puzzles.push_back(puzzle);
+    }
+    return corpus;
+}
+
+/**
+ * Reads every puzzle of a file in the grid or one-line format.
+ * @param name the corpus name
+ * @param path the file
+ * @return the corpus, empty if the file cannot be read
+*/
+static Corpus fileCorpus(const string &name, const string &path)
+{
+    Corpus corpus;
+    corpus.name = name;
+    PuzzleFile file(9);
+    if (file.open(path))
+    {
+        for (int i = 0; i < file.size(); i++)
+            corpus.puzzles.push_back(file.text(i));
+    }
+    return corpus;
+}
+
+/**
+ * Parses a configuration name made of '+'-separated parts: first or mrv, prop, dlx, split:D, count:L
+ * or unique (count:2) to count solutions instead of solving, lockstep to solve in vectorized groups and
+ * cache to reuse the solutions of puzzles equal up to symmetry, nodes:N and ms:T to give up on a puzzle after
+ * N recursive calls or T milliseconds.
+ * @param name the configuration name, e.g. "mrv+prop"
+ * @param config receives the configuration
+ * @return false if a part is not recognized
+*/
+static bool parseConfig(const string &name, Config &config)
+{
+    config.name = name;
+    config.options = SolverOptions();
+    stringstream parts(name);
+    string part;
+    while (getline(parts, part, '+'))
+    {
+        if (part == "first")
+            config.options.selection = FirstEmpty;
+        else if (part == "mrv")
+            config.options.selection = MinRemaining;
+        else if (part == "prop")
+            config.options.propagate = true;
+        else if (part == "dlx")
+            config.options.useDlx = true;
+        else if (part.compare(0, 6, "split:") == 0)
+            config.options.splitDepth = atoi(part.c_str() + 6);
+        else if (part.compare(0, 6, "count:") == 0)
+            config.options.countLimit = atol(part.c_str() + 6);
+        else if (part == "unique")
+            config.options.countLimit = 2;
+        else if (part == "lockstep")
+            config.options.lockstep = true;
+        else if (part == "cache")
+            config.cache = true;
+        else if (part.compare(0, 6, "nodes:") == 0)
+            config.options.budget.nodes = atol(part.c_str() + 6);
+        else if (part.compare(0, 3, "ms:") == 0)
+            config.options.budget.nanos = (long long)(atof(part.c_str() + 3) * 1e6);
+        else
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Solves every puzzle of a corpus with one configuration, repeat times, keeping each puzzle's fastest time.
+ * @param corpus the puzzles
+ * @param config the solver configuration
+ * @param repeat the number of passes
+ * @param pool the pool used by split configurations
+ * @return the measurements
+*/
+static Measurement measure(const Corpus &corpus, const Config &config, int repeat, ThreadPool &pool)
+{
+    int total = corpus.puzzles.size();
+    Measurement m;
+    m.nanos.assign(total, 0);
+    m.nodes.assign(total, 0);
+    m.backtracks.assign(total, 0);
+    m.solved.assign(total, 0);
+
+    SudokuBoard board(9);
+    board.setSelection(config.options.selection);
+    board.setPropagation(config.options.propagate);
+    DancingLinks* dlx = config.options.useDlx ? new DancingLinks(9) : NULL;
+    const SolverOptions &opts = config.options;
+    bool lockstep = opts.lockstep && !opts.useDlx && opts.splitDepth == 0 && opts.countLimit == 0;
+    LockstepSolver group(opts.selection, opts.propagate, opts.budget);
+
+    for (int pass = 0; pass < repeat; pass++)
+    {
+        // a cache kept across passes would turn every later pass into lookups
+        SolutionCache cache;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        // a group's propagation time is shared equally among its puzzles
+        for (int i = 0; lockstep && i < total; i += LockstepSolver::Lanes)
+        {
+            PuzzleResult results[LockstepSolver::Lanes];
+            int count = min(LockstepSolver::Lanes, total - i);
+            group.solve(&corpus.puzzles[i], count, results);
+            for (int k = 0; k < count; k++)
+            {
+                if (pass == 0 || results[k].nanos < m.nanos[i + k])
+                    m.nanos[i + k] = results[k].nanos;
+                m.nodes[i + k] = results[k].recursiveCount - 1;
+                m.backtracks[i + k] = results[k].backtracksCount;
+                m.solved[i + k] = results[k].solved;
+            }
+        }
+        for (int i = 0; !lockstep && i < total; i++)
+        {
+            PuzzleResult result;
+            board.initializeBoard(corpus.puzzles[i]);
+            BatchSolver::solveBoard(board, dlx, result, &pool, config.options.splitDepth, config.options.countLimit,
+                                   config.cache ? &cache : NULL, config.options.budget);
+            if (pass == 0 || result.nanos < m.nanos[i])
+                m.nanos[i] = result.nanos;
+            m.nodes[i] = result.recursiveCount - 1;
+            m.backtracks[i] = result.backtracksCount;
+            m.solved[i] = result.solved;
+        }
+        long long wall = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+        if (pass == 0 || wall < m.wallNanos)
+            m.wallNanos = wall;
+    }
+    delete dlx;
+    return m;
+}
+
+/**
+ * Nearest-rank percentile of a sorted list.
+ * @param sorted the values in ascending order
+ * @param p the percentile, 0 to 100
+ * @return the value, or 0 for an empty list
+*/
+static long long percentile(const vector<long long> &sorted, double p)
+{
+    if (sorted.empty())
+        return 0;
+    int rank = (int)(p / 100.0 * sorted.size() + 0.999999);
+    rank = max(1, min(rank, (int)sorted.size()));
+    return sorted[rank - 1];
+}
+
+/**
+ * Prints the table header for one corpus.
+ * @param corpus the corpus
+*/
+static void printHeader(const Corpus &corpus)
+{
+    cout << "\n***** Corpus " << corpus.name << " (" << corpus.puzzles.size() << " puzzles) ******\n";
+    // every column starts with a space, so a value wider than its column still stands apart
+    cout << left << setw(18) << "config" << right
+         << ' ' << setw(9) << "solved"
+         << ' ' << setw(10) << "p50 us" << ' ' << setw(10) << "p90 us" << ' ' << setw(10) << "p99 us"
+         << ' ' << setw(10) << "max us" << ' ' << setw(10) << "p50 nodes" << ' ' << setw(10) << "max nodes"
+         << ' ' << setw(12) << "avg backtr" << ' ' << setw(12) << "puzzles/s" << ' ' << setw(14) << "speedup"
+         << "\n";
+}
+
+/**
+ * Prints one row of the comparison table.
+ * @param config the configuration
+ * @param m its measurements
+ * @param baseline the puzzles per second of the first configuration, 0 for the first itself
+ * @return the puzzles per second of this configuration
+*/
+static double printRow(const Config &config, const Measurement &m, double baseline)
+{
+    vector<long long> nanos = m.nanos, nodes = m.nodes;
+    sort(nanos.begin(), nanos.end());
+    sort(nodes.begin(), nodes.end());
+
+    int total = m.nanos.size();
+    int solved = count(m.solved.begin(), m.solved.end(), 1);
+    double backtr = 0;
+    for (int i = 0; i < total; i++)
+        backtr += m.backtracks[i];
+    double rate = (m.wallNanos > 0) ? total * 1e9 / m.wallNanos : 0;
+
+    ostringstream ratio;
+    ratio << fixed << setprecision(2) << (baseline > 0 ? rate / baseline : 1.0) << "x";
+    ostringstream solvedText;
+    solvedText << solved << "/" << total;
+
+    cout << left << setw(18) << config.name << right << fixed << setprecision(1)
+         << ' ' << setw(9) << solvedText.str()
+         << ' ' << setw(10) << percentile(nanos, 50) / 1000.0 << ' ' << setw(10) << percentile(nanos, 90) / 1000.0
+         << ' ' << setw(10) << percentile(nanos, 99) / 1000.0 << ' ' << setw(10) << percentile(nanos, 100) / 1000.0
+         << ' ' << setw(10) << percentile(nodes, 50) << ' ' << setw(10) << percentile(nodes, 100)
+         << ' ' << setw(12) << (total > 0 ? backtr / total : 0.0)
+         << ' ' << setw(12) << setprecision(0) << rate << ' ' << setw(14) << ratio.str() << "\n";
+    cout.unsetf(ios::floatfield);
+    return rate;
+}
+
+
+int main(int argc, char* argv[])
+{
+    vector<string> corpusNames;
+    vector<string> configNames;
+    int count = 100; // puzzles in each generated corpus
+    int repeat = 1;
+    unsigned int seed = 1;
+    string recordsPath;
+    string path96 = "Sudoku96Puzzles.txt";
+
+    // "--corpus NAME" 96, easy, hard, 17 or a puzzle file; repeatable, all four built-in corpora by default
+    // "--config NAME" '+'-separated parts: first|mrv, prop, dlx, split:D, count:L|unique, lockstep,
+    //                cache, nodes:N, ms:T;
+    //                repeatable, the first is the baseline
+    // "--count N" puzzles in each generated corpus
+    // "--repeat R" passes over every corpus, each puzzle keeps its fastest time
+    // "--seed S" seed of the generated corpora
+    // "--records FILE" writes one CSV line per puzzle and configuration
+    // "--puzzles96 FILE" where to find the 96 puzzle corpus
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--corpus") == 0 && i + 1 < argc)
+            corpusNames.push_back(argv[++i]);
+        else if (strcmp(argv[i], "--config") == 0 && i + 1 < argc)
+            configNames.push_back(argv[++i]);
+        else if (strcmp(argv[i], "--count") == 0 && i + 1 < argc)
+            count = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+            repeat = max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            seed = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--records") == 0 && i + 1 < argc)
+            recordsPath = argv[++i];
+        else if (strcmp(argv[i], "--puzzles96") == 0 && i + 1 < argc)
+            path96 = argv[++i];
+        else
+        {
+            cerr << "Unknown option " << argv[i] << endl;
+            exit(1);
+        }
+    }
+    if (corpusNames.empty())
+        corpusNames = {"96", "easy", "hard", "17"};
+    if (configNames.empty())
+        configNames = {"mrv", "mrv+prop", "dlx"};
+
+    vector<Config> configs;
+    for (int i = 0; i < (int)configNames.size(); i++)
+    {
+        Config config;
+        if (!parseConfig(configNames[i], config))
+        {
+            cerr << "Unknown configuration " << configNames[i] << endl;
+            exit(1);
+        }
+        configs.push_back(config);
+    }
+
+    // the corpora are built before anything is timed
+    mt19937 rng(seed);
+    vector<Corpus> corpora;
+    Corpus base = fileCorpus("96", path96);
+    for (int i = 0; i < (int)corpusNames.size(); i++)
+    {
+        const string &name = corpusNames[i];
+        Corpus corpus;
+        if (name == "96")
+            corpus = base;
+        else if (name == "hard")
+            corpus = variants("hard", HardSeeds, sizeof(HardSeeds) / sizeof(HardSeeds[0]), count, rng);
+        else if (name == "17")
+            corpus = variants("17", SeventeenSeeds, sizeof(SeventeenSeeds) / sizeof(SeventeenSeeds[0]), count, rng);
+        else if (name == "easy")
+        {
+            // the solutions of the 96 puzzles, or of the hard seeds when that file is missing
+            vector<string> solutions;
+            SudokuBoard board(9);
+            DancingLinks dlx(9);
+            vector<string> sources = base.puzzles;
+            if (sources.empty())
+                sources.assign(HardSeeds, HardSeeds + sizeof(HardSeeds) / sizeof(HardSeeds[0]));
+            for (int k = 0; k < (int)sources.size(); k++)
+            {
+                int recur = 0, backtrack = 0;
+                board.initializeBoard(sources[k]);
+                if (dlx.solve(board, recur, backtrack))
+                    solutions.push_back(board.toString());
+            }
+            corpus = easyPuzzles(solutions, count, rng);
+        }
+        else
+            corpus = fileCorpus(name, name);
+
+        if (corpus.puzzles.empty())
+        {
+            cerr << "No puzzles in corpus " << name << endl;
+            exit(1);
+        }
+        corpora.push_back(corpus);
+    }
+
+    OutputWriter records;
+    if (!recordsPath.empty())
+    {
+        if (!records.open(recordsPath))
+        {
+            cerr << "Cannot open " << recordsPath << endl;
+            exit(1);
+        }
+        records << "corpus,config,index,solved,recursive_calls,backtracks,solve_ns\n";
+    }
+
+    ThreadPool pool(0);
+    for (int c = 0; c < (int)corpora.size(); c++)
+    {
+        printHeader(corpora[c]);
+        double baseline = 0;
+        for (int k = 0; k < (int)configs.size(); k++)
+        {
+            Measurement m = measure(corpora[c], configs[k], repeat, pool);
+            double rate = printRow(configs[k], m, baseline);
+            if (k == 0)
+                baseline = rate;
+
+            for (int i = 0; !recordsPath.empty() && i < (int)m.nanos.size(); i++)
+                records << corpora[c].name << ',' << configs[k].name << ',' << i << ',' << (int)m.solved[i] << ','
+                        << m.nodes[i] << ',' << m.backtracks[i] << ',' << m.nanos[i] << '\n';
+        }
+    }
+    cout << endl;
+    return 0;
+}
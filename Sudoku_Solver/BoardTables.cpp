@@ -0,0 +1,38 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author : Ajinkya Joshi, Anthony Chamoun
+* Date : March 15, 2023
+* File name : BoardTables.cpp - Unit tables by size
+* Purpose : Gives the compile-time tables of every square size to code
+*           that only knows the size at run time
+****************************************************************************/
+
+#include "BoardTables.h"
+#include <cstddef>
+
+using namespace std;
+
+/**
+ * Makes the run-time view of the tables of one square size.
+ * @return The view, pointing into boardTables<Box>.
+*/
+template <int Box>
+static constexpr UnitTables viewOf()
+{
+    return UnitTables{ Box * Box, BoardTables<Box>::PeerCount, boardTables<Box>.rowOf, boardTables<Box>.colOf,
+                       boardTables<Box>.sqOf, &boardTables<Box>.units[0][0], &boardTables<Box>.peers[0][0] };
+}
+
+static constexpr UnitTables views[] = { viewOf<2>(), viewOf<3>(), viewOf<4>(), viewOf<5>(), viewOf<6>() };
+
+/**
+ * Returns the tables of a square size.
+ * @param box: The side of a square
+ * @return The tables, or NULL if the size has none
+*/
+const UnitTables* unitTables(int box)
+{
+    if (box < 2 || box > 6)
+        return NULL;
+    return &views[box - 2];
+}
@@ -0,0 +1,98 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author          :Ajinkya Joshi, Anthony Chamoun
+* Date            :March 15th, 2023
+* File name       :BoardTables.h
+* Purpose         :Row, column, square, unit and peer tables of every
+*                  supported board size, built by the compiler.
+ **************************************************************************/
+
+#ifndef BOARDTABLES_H
+#define BOARDTABLES_H
+#include <cstdint>
+
+/**
+* The unit membership of every cell of a board made of Box x Box squares. Units 0..N-1 are the rows, N..2N-1
+* the columns and 2N..3N-1 the squares, squares numbered row-major from the top left. The peers of a cell are
+* the other cells sharing a unit with it, in increasing order.
+*/
+template <int Box>
+struct BoardTables
+{
+    static const int N = Box * Box;
+    static const int Cells = N * N;
+    static const int Units = 3 * N;
+    static const int PeerCount = 2 * (N - 1) + (Box - 1) * (Box - 1);
+
+    uint16_t rowOf[Cells];
+    uint16_t colOf[Cells];
+    uint16_t sqOf[Cells];
+    uint16_t units[Units][N];
+    uint16_t peers[Cells][PeerCount];
+
+    constexpr BoardTables() : rowOf(), colOf(), sqOf(), units(), peers()
+    {
+        for (int cell = 0; cell < Cells; cell++)
+        {
+            int r = cell / N, c = cell % N;
+            int sq = (r / Box) * Box + c / Box;
+            rowOf[cell] = r;
+            colOf[cell] = c;
+            sqOf[cell] = sq;
+            units[r][c] = cell;
+            units[N + c][r] = cell;
+            units[2 * N + sq][(r % Box) * Box + c % Box] = cell;
+
+            // row by row: the whole row of the cell, the columns of its square in the rows of its band,
+            // and its own column in every other row
+            int n = 0;
+            for (int r2 = 0; r2 < N; r2++)
+            {
+                if (r2 == r)
+                {
+                    for (int c2 = 0; c2 < N; c2++)
+                        if (c2 != c)
+                            peers[cell][n++] = r2 * N + c2;
+                }
+                else if (r2 / Box == r / Box)
+                {
+                    for (int c2 = (c / Box) * Box; c2 < (c / Box + 1) * Box; c2++)
+                        peers[cell][n++] = r2 * N + c2;
+                }
+                else
+                    peers[cell][n++] = r2 * N + c;
+            }
+        }
+    }
+};
+
+/**
+* The tables of one square size, built at compile time; one copy is shared by the whole program.
+*/
+template <int Box>
+inline constexpr BoardTables<Box> boardTables{};
+
+/**
+* The tables of a square size chosen at run time, for code that handles every size with the same loops.
+* Units and peers are flat: unit u starts at units[u * unitSize] and the peers of cell c at
+* peers[c * peerCount].
+*/
+struct UnitTables
+{
+    int unitSize;
+    int peerCount;
+    const uint16_t* rowOf;
+    const uint16_t* colOf;
+    const uint16_t* sqOf;
+    const uint16_t* units;
+    const uint16_t* peers;
+};
+
+/**
+* Returns the tables of a square size.
+* @param box The side of a square, 2 to 6.
+* @return The tables, or NULL for an unsupported size.
+*/
+const UnitTables* unitTables(int box);
+
+#endif
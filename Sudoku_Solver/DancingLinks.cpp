@@ -0,0 +1,268 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author : Ajinkya Joshi, Anthony Chamoun
+* Date : March 15, 2023
+* File name : DancingLinks.cpp - Solve Sudoku Puzzles as an exact cover problem
+* Purpose : Knuth's Algorithm X over a preallocated dancing links matrix
+****************************************************************************/
+
+#include "DancingLinks.h"
+
+using namespace std;
+
+/**************************************************************************
+ * Constructor
+****************************************************************************/
+
+
+/**
+ * Builds the dancing links matrix for an N x N board: one header per constraint column followed by four
+ * nodes for each of the N^3 (cell, digit) options. The matrix is built once and every solve leaves it
+ * exactly as it found it.
+ * @param N: The size of the board
+*/
+DancingLinks::DancingLinks(int N) : boardSize(N), solutions(0), solutionLimit(1)
+{
+    squareSize = 1;
+    while (squareSize * squareSize < N)
+        squareSize++;
+
+    int cells = N * N;
+    columnCount = 4 * cells;
+    int nodeCount = 1 + columnCount + 4 * cells * N;
+    left.resize(nodeCount);
+    right.resize(nodeCount);
+    up.resize(nodeCount);
+    down.resize(nodeCount);
+    column.resize(nodeCount);
+    option.resize(nodeCount, -1);
+    size.assign(columnCount + 1, 0);
+    chosen.reserve(cells);
+
+    // root and column headers form one circular list
+    for (int c = 0; c <= columnCount; c++)
+    {
+        left[c] = c - 1;
+        right[c] = c + 1;
+        up[c] = c;
+        down[c] = c;
+        column[c] = c;
+    }
+    left[0] = columnCount;
+    right[columnCount] = 0;
+
+    int node = columnCount + 1;
+    for (int row = 0; row < N; row++)
+        for (int col = 0; col < N; col++)
+            for (int digit = 0; digit < N; digit++)
+            {
+                int sq = (row / squareSize) * squareSize + col / squareSize;
+                int cols[4] = {
+                    1 + row * N + col,
+                    1 + cells + row * N + digit,
+                    1 + 2 * cells + col * N + digit,
+                    1 + 3 * cells + sq * N + digit
+                };
+                int first = node;
+                for (int k = 0; k < 4; k++, node++)
+                {
+                    int c = cols[k];
+                    // append the node to the bottom of its column
+                    column[node] = c;
+                    option[node] = (row * N + col) * N + digit;
+                    up[node] = up[c];
+                    down[node] = c;
+                    down[up[c]] = node;
+                    up[c] = node;
+                    size[c]++;
+                    // and to the end of its row
+                    left[node] = (k == 0) ? node : node - 1;
+                    right[node] = first;
+                    right[left[node]] = node;
+                    left[first] = node;
+                }
+            }
+}
+
+
+/**************************************************************************
+ * Methods involved in the algorithm
+****************************************************************************/
+
+/**
+ * Covers a column: unlinks its header and removes every row that uses it from the other columns.
+ * @param c The column header to cover.
+*/
+void DancingLinks::cover(int c)
+{
+    right[left[c]] = right[c];
+    left[right[c]] = left[c];
+    for (int i = down[c]; i != c; i = down[i])
+        for (int j = right[i]; j != i; j = right[j])
+        {
+            down[up[j]] = down[j];
+            up[down[j]] = up[j];
+            size[column[j]]--;
+        }
+}
+
+/**
+ * Uncovers a column, relinking everything cover removed in the opposite order.
+ * @param c The column header to uncover.
+*/
+void DancingLinks::uncover(int c)
+{
+    for (int i = up[c]; i != c; i = up[i])
+        for (int j = left[i]; j != i; j = left[j])
+        {
+            size[column[j]]++;
+            down[up[j]] = j;
+            up[down[j]] = j;
+        }
+    right[left[c]] = c;
+    left[right[c]] = c;
+}
+
+/**
+ * Algorithm X. Picks the live column with the fewest nodes, then tries each row in it, covering the
+ * columns of that row before recursing and uncovering them afterwards.
+ * @param recur an integer reference to keep track of the number of recursive calls
+ * @param backtrack an integer reference to keep track of the number of times the function backtracks
+ * @return true once the requested number of solutions has been found
+*/
+bool DancingLinks::search(int &recur, int &backtrack)
+{
+    recur += 1;
+
+    // every constraint is covered: one more solution
+    if (right[0] == 0)
+    {
+        if (solutions == 0)
+            firstSolution = chosen;
+        solutions++;
+        return solutions >= solutionLimit;
+    }
+
+    int c = right[0];
+    for (int j = right[c]; j != 0; j = right[j])
+        if (size[j] < size[c])
+            c = j;
+
+    cover(c);
+    for (int r = down[c]; r != c; r = down[r])
+    {
+        chosen.push_back(r);
+        for (int j = right[r]; j != r; j = right[j])
+            cover(column[j]);
+
+        bool done = search(recur, backtrack);
+
+        for (int j = left[r]; j != r; j = left[j])
+            uncover(column[j]);
+        chosen.pop_back();
+
+        if (done)
+        {
+            uncover(c);
+            return true;
+        }
+        backtrack++;
+    }
+    uncover(c);
+    return false;
+}
+
+/**
+ * Selects the option row of every clue on the board by covering its four columns.
+ * @param board The board holding the clues.
+ * @param givens Receives the option node of each clue, in the order they were covered.
+ * @return False if a clue collides with an earlier one; the links are restored before returning.
+*/
+bool DancingLinks::coverGivens(SudokuBoard &board, vector<int> &givens)
+{
+    givens.clear();
+    for (int row = 0; row < boardSize; row++)
+        for (int col = 0; col < boardSize; col++)
+        {
+            int digit = board.getCell(row, col);
+            if (digit == Blank)
+                continue;
+
+            int r = columnCount + 1 + 4 * ((row * boardSize + col) * boardSize + digit - 1);
+            // a covered column means another clue already satisfies this constraint
+            for (int j = r, k = 0; k < 4; j = right[j], k++)
+                if (right[left[column[j]]] != column[j])
+                {
+                    uncoverGivens(givens);
+                    return false;
+                }
+
+            cover(column[r]);
+            for (int j = right[r]; j != r; j = right[j])
+                cover(column[j]);
+            givens.push_back(r);
+        }
+    return true;
+}
+
+/**
+ * Uncovers the clue rows selected by coverGivens, last one first.
+ * @param givens The option nodes returned by coverGivens.
+*/
+void DancingLinks::uncoverGivens(vector<int> &givens)
+{
+    for (int g = (int)givens.size() - 1; g >= 0; g--)
+    {
+        int r = givens[g];
+        for (int j = left[r]; j != r; j = left[j])
+            uncover(column[j]);
+        uncover(column[r]);
+    }
+    givens.clear();
+}
+
+/**
+ * Solves the board in place with Algorithm X.
+ * @param board The board to solve.
+ * @param recur an integer reference to keep track of the number of recursive calls
+ * @param backtrack an integer reference to keep track of the number of times the search backtracks
+ * @return a boolean value indicating if the Sudoku puzzle has been successfully solved
+*/
+bool DancingLinks::solve(SudokuBoard &board, int &recur, int &backtrack)
+{
+    return countSolutions(board, 1, recur, backtrack) == 1;
+}
+
+/**
+ * Counts the solutions of the board up to a limit and writes the first one into the board.
+ * @param board The board to solve.
+ * @param limit The search stops after this many solutions.
+ * @param recur an integer reference to keep track of the number of recursive calls
+ * @param backtrack an integer reference to keep track of the number of times the search backtracks
+ * @return The number of solutions found, never more than limit.
+*/
+long DancingLinks::countSolutions(SudokuBoard &board, long limit, int &recur, int &backtrack)
+{
+    vector<int> givens;
+    solutions = 0;
+    solutionLimit = limit;
+    chosen.clear();
+    firstSolution.clear();
+
+    if (!coverGivens(board, givens))
+    {
+        recur += 1;
+        return 0;
+    }
+    search(recur, backtrack);
+    uncoverGivens(givens);
+
+    // copy the first solution back onto the board
+    for (int i = 0; i < (int)firstSolution.size(); i++)
+    {
+        int opt = option[firstSolution[i]];
+        int cell = opt / boardSize;
+        board.setCell(cell / boardSize, cell % boardSize, opt % boardSize + 1);
+    }
+    return solutions;
+}
@@ -0,0 +1,101 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author          :Ajinkya Joshi, Anthony Chamoun
+* Date            :March 15th, 2023
+* File name       :DancingLinks.h
+* Purpose         :Exact cover (Algorithm X / Dancing Links) solver for
+*                  boards loaded into a SudokuBoard.
+ **************************************************************************/
+
+#ifndef DANCINGLINKS_H
+#define DANCINGLINKS_H
+#include <vector>
+#include "SudokuBoard.h"
+
+using namespace std;
+
+class DancingLinks
+{
+
+/*
+ * The board is modelled as an exact cover problem. Every (cell, digit) pair is an option that covers four
+ * constraint columns: the cell itself, the digit in its row, the digit in its column and the digit in its
+ * square. All nodes live in flat link arrays sized once by the constructor, node 0 being the root header
+ * and nodes 1..columnCount the column headers.
+*/
+private:
+    int boardSize, squareSize;
+    int columnCount; // 4 * boardSize^2 constraint columns
+    vector<int> left, right, up, down; // circular links of every node
+    vector<int> column; // column header of every node
+    vector<int> option; // option (cell * boardSize + digit - 1) owning every node
+    vector<int> size; // number of live nodes in each column
+    vector<int> chosen; // stack of the option nodes picked by the search
+    vector<int> firstSolution; // options of the first solution found
+    long solutions; // solutions found by the current search
+    long solutionLimit; // search stops once this many solutions are found
+
+    /**
+    * Removes a column from the header list and every row crossing it from the other columns.
+    * @param c The column header to cover.
+    */
+    void cover(int c);
+
+    /**
+    * Restores a column removed by cover. Calls must be made in the reverse order of cover.
+    * @param c The column header to uncover.
+    */
+    void uncover(int c);
+
+    /**
+    * Recursive Algorithm X search, always branching on the column with the fewest nodes.
+    * @param recur Incremented once per call.
+    * @param backtrack Incremented every time a branch fails.
+    * @return True once solutionLimit solutions have been found.
+    */
+    bool search(int &recur, int &backtrack);
+
+    /**
+    * Covers the columns of the clues already on the board.
+    * @param board The board to read the clues from.
+    * @param givens Filled with the option nodes selected for the clues.
+    * @return False if two clues conflict, in which case nothing is left covered.
+    */
+    bool coverGivens(SudokuBoard &board, vector<int> &givens);
+
+    /**
+    * Undoes coverGivens, restoring the links to their state after construction.
+    * @param givens The option nodes returned by coverGivens.
+    */
+    void uncoverGivens(vector<int> &givens);
+
+public:
+
+    /**
+    * Builds the full exact cover matrix for an N x N board.
+    * @param N The size of the board. Default value is 9.
+    */
+    DancingLinks(int N = 9);
+
+    /**
+    * Solves the board in place.
+    * @param board The board to solve, as loaded by initializeBoard.
+    * @param recur The number of recursive calls made during the solving process.
+    * @param backtrack The number of times the solver backtracked during the solving process.
+    * @return True if the board is solvable, false otherwise.
+    */
+    bool solve(SudokuBoard &board, int &recur, int &backtrack);
+
+    /**
+    * Counts the solutions of the board, stopping early once limit solutions are found.
+    * The first solution found is written into the board.
+    * @param board The board to solve.
+    * @param limit The largest count of interest, e.g. 2 to check for a unique solution.
+    * @param recur The number of recursive calls made during the search.
+    * @param backtrack The number of times the search backtracked.
+    * @return The number of solutions found, at most limit.
+    */
+    long countSolutions(SudokuBoard &board, long limit, int &recur, int &backtrack);
+};
+
+#endif
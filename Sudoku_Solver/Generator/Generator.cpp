@@ -0,0 +1,131 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author : Ajinkya Joshi, Anthony Chamoun
+* Date : March 15, 2023
+* File name : Generator.cpp - Puzzle generator
+* Purpose : Writes random puzzles with a unique solution, one per line in
+*           the format initializeBoard and PuzzleFile read
+* Usage : (from Sudoku_Solver/Generator)
+*         g++ -O2 -pthread -I.. Generator.cpp ../[A-Z][a-z]*.cpp -o generator
+*         ./generator [--count N] [--first I] [--size N] [--clues C] [--difficulty any|easy|medium|hard]
+*                     [--symmetric] [--seed S] [--attempts A] [--threads T] [--solutions] [--output FILE]
+****************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+#include "SudokuBoard.h"
+#include "PuzzleGenerator.h"
+#include "OutputWriter.h"
+
+using namespace std;
+
+
+int main(int argc, char* argv[])
+{
+    GeneratorOptions options;
+    int count = 100;
+    long long first = 0; // index of the first puzzle, to continue an earlier run with the same seed
+    int threads = 0;
+    bool solutions = false;
+    string outputPath;
+
+    // "--count N" puzzles to write
+    // "--first I" index of the first puzzle; runs with the same seed and options give the same puzzle at an index
+    // "--size N" board size, 4, 9, 16, 25 or 36
+    // "--clues C" stop removing clues at C, as few as uniqueness allows by default
+    // "--difficulty D" any, easy (singles only), medium (locked candidates, no guessing) or hard (needs guessing)
+    // "--symmetric" removes clues in pairs mirrored through the centre
+    // "--seed S" seed of the run
+    // "--attempts A" grids tried per puzzle before writing one that misses the targets
+    // "--threads T" worker threads, 0 = all cores
+    // "--solutions" writes each solution after its puzzle on the same line
+    // "--output FILE" writes to FILE instead of the console
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--count") == 0 && i + 1 < argc)
+            count = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--first") == 0 && i + 1 < argc)
+            first = atoll(argv[++i]);
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+            options.boardSize = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--clues") == 0 && i + 1 < argc)
+            options.clues = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--symmetric") == 0)
+            options.symmetric = true;
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+            options.seed = strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--attempts") == 0 && i + 1 < argc)
+            options.maxAttempts = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--solutions") == 0)
+            solutions = true;
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+            outputPath = argv[++i];
+        else if (strcmp(argv[i], "--difficulty") == 0 && i + 1 < argc)
+        {
+            const char* name = argv[++i];
+            if (strcmp(name, "any") == 0)
+                options.difficulty = AnyDifficulty;
+            else if (strcmp(name, "easy") == 0)
+                options.difficulty = Easy;
+            else if (strcmp(name, "medium") == 0)
+                options.difficulty = Medium;
+            else if (strcmp(name, "hard") == 0)
+                options.difficulty = Hard;
+            else
+            {
+                cerr << "Unknown difficulty " << name << endl;
+                exit(1);
+            }
+        }
+        else
+        {
+            cerr << "Unknown option " << argv[i] << endl;
+            exit(1);
+        }
+    }
+    if (!SudokuBoard::supportedSize(options.boardSize))
+    {
+        cerr << "Unsupported board size " << options.boardSize << endl;
+        exit(1);
+    }
+
+    OutputWriter out;
+    if (outputPath.empty())
+        out.echo(true);
+    else if (!out.open(outputPath))
+    {
+        cerr << "Cannot open " << outputPath << endl;
+        exit(1);
+    }
+
+    // one puzzle per line, followed by its index, clue count and band, which PuzzleFile ignores
+    int missed = 0;
+    long long totalClues = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    PuzzleGenerator generator(threads, options);
+    generator.generateAll(first, count, [&](long long index, GeneratedPuzzle &puzzle) {
+        out << puzzle.puzzle;
+        if (solutions)
+            out << ' ' << puzzle.solution;
+        out << " # " << index << ' ' << puzzle.clues << " clues " << PuzzleGenerator::difficultyName(puzzle.difficulty)
+            << '\n';
+        totalClues += puzzle.clues;
+        if (!puzzle.matched)
+            missed++;
+    });
+    out.flush();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cerr << count << " puzzles in " << seconds << " s (" << (seconds > 0 ? count / seconds : 0.0)
+         << " puzzles/s, " << (count > 0 ? (double)totalClues / count : 0.0) << " clues on average) on "
+         << generator.threadCount() << " threads" << endl;
+    if (missed > 0)
+        cerr << missed << " puzzles missed the clue or difficulty target after " << options.maxAttempts
+             << " attempts" << endl;
+    return 0;
+}
@@ -0,0 +1,243 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author : Ajinkya Joshi, Anthony Chamoun
+* Date : March 15, 2023
+* File name : LockstepSolver.cpp - Singles on many boards at once
+* Purpose : Runs naked and hidden singles on 16 boards in lockstep with
+*           vector instructions chosen at run time
+****************************************************************************/
+
+#include "LockstepSolver.h"
+#include "BoardTables.h"
+#include <cstdint>
+#include <cstring>
+#include <cctype>
+#include <chrono>
+#include <algorithm>
+
+using namespace std;
+
+// the kernel is cloned for AVX2 and the baseline; the loader picks the clone matching the CPU
+#if defined(__GNUC__) && defined(__x86_64__)
+#define LOCKSTEP_CLONES __attribute__((target_clones("avx2", "default")))
+#else
+#define LOCKSTEP_CLONES
+#endif
+
+/**
+ * One candidate mask per board of a group, lane l belonging to board l. The compiler maps operations on it to
+ * one AVX2 instruction, two SSE2 instructions or a loop, depending on what the function is compiled for.
+*/
+typedef uint16_t LaneMask __attribute__((vector_size(2 * LockstepSolver::Lanes)));
+
+static const uint16_t FullMask = 0x1ff;
+
+const int LockstepSolver::Lanes;
+
+// the 20 peers of every cell and the cells of every unit of a 9 x 9 board
+static constexpr const BoardTables<3> &tables = boardTables<3>;
+
+/**
+ * Tells whether any lane of a mask is non-zero.
+ * @param v the mask
+ * @return true if some lane is set
+*/
+static inline bool anyLane(const LaneMask &v)
+{
+    uint64_t words[sizeof(LaneMask) / 8];
+    memcpy(words, &v, sizeof(LaneMask));
+    uint64_t all = 0;
+    for (int i = 0; i < (int)(sizeof(LaneMask) / 8); i++)
+        all |= words[i];
+    return all != 0;
+}
+
+/**
+ * Applies naked and hidden singles to every lane until no lane changes. Every step is done on all lanes, so
+ * there is no branch per board; a lane that has nothing left to deduce just stops changing.
+ * @param cand The candidates of the 81 cells; reduced in place.
+ * @param dead Set to all ones in the lanes found to be contradictory.
+*/
+LOCKSTEP_CLONES
+static void propagateLanes(LaneMask* cand, LaneMask &dead)
+{
+    const LaneMask zero = {};
+    const LaneMask full = zero + FullMask;
+    LaneMask done[81]; // the digit of each cell once it has been removed from the peers
+    for (int cell = 0; cell < 81; cell++)
+        done[cell] = zero;
+    dead = zero;
+
+    for (;;)
+    {
+        LaneMask changed = zero;
+
+        // naked singles: a cell left with one digit removes it from its peers
+        for (int cell = 0; cell < 81; cell++)
+        {
+            LaneMask v = cand[cell];
+            LaneMask single = (LaneMask)((v & (v - 1)) == zero);
+            LaneMask fresh = v & single & ~done[cell];
+            done[cell] |= fresh;
+            changed |= fresh;
+            for (int k = 0; k < 20; k++)
+                cand[tables.peers[cell][k]] &= ~fresh;
+        }
+
+        // hidden singles: a digit with one place left in a unit goes there
+        for (int unit = 0; unit < 27; unit++)
+        {
+            const uint16_t* cells = tables.units[unit];
+            LaneMask once = zero, twice = zero;
+            for (int k = 0; k < 9; k++)
+            {
+                LaneMask v = cand[cells[k]];
+                twice |= once & v;
+                once |= v;
+            }
+            dead |= (LaneMask)(once != full);
+
+            LaneMask exactly = once & ~twice;
+            for (int k = 0; k < 9; k++)
+            {
+                LaneMask v = cand[cells[k]];
+                LaneMask hidden = v & exactly;
+                LaneMask found = (LaneMask)(hidden != zero);
+                // two digits that both fit only this cell
+                dead |= found & (LaneMask)((hidden & (hidden - 1)) != zero);
+                LaneMask next = (hidden & found) | (v & ~found);
+                changed |= next ^ v;
+                cand[cells[k]] = next;
+            }
+        }
+
+        if (!anyLane(changed))
+            break;
+    }
+}
+
+
+/**************************************************************************
+ * Constructor
+****************************************************************************/
+
+
+/**
+ * Creates the fallback board.
+ * @param order: Branching heuristic of the fallback search
+ * @param propagate: True to propagate at every node of the fallback search
+ * @param limits: Limits of the fallback search
+*/
+LockstepSolver::LockstepSolver(SelectionOrder order, bool propagate, SearchBudget limits) : board(9), budget(limits)
+{
+    board.setSelection(order);
+    board.setPropagation(propagate);
+}
+
+
+/**************************************************************************
+ * Solving
+****************************************************************************/
+
+/**
+ * Names the clone the loader picked for this CPU.
+ * @return The instruction set name.
+*/
+const char* LockstepSolver::instructionSet()
+{
+#if defined(__GNUC__) && defined(__x86_64__)
+    return __builtin_cpu_supports("avx2") ? "avx2" : "sse2";
+#else
+    return "generic";
+#endif
+}
+
+/**
+ * Loads the group into the lanes, propagates, then reads every lane back: a contradictory lane is unsolvable,
+ * a lane with one digit in every cell is solved, and any other lane is handed with its deductions to the
+ * fallback board.
+ * @param puzzles The puzzles.
+ * @param count The number of puzzles, at most Lanes.
+ * @param results Receives the outcomes.
+ * @return The number of puzzles that needed the fallback search.
+*/
+int LockstepSolver::solve(const string* puzzles, int count, PuzzleResult* results)
+{
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    // unused lanes hold an empty board, on which no single ever fires
+    LaneMask cand[81];
+    for (int cell = 0; cell < 81; cell++)
+    {
+        for (int lane = 0; lane < Lanes; lane++)
+            cand[cell][lane] = FullMask;
+    }
+    for (int lane = 0; lane < count; lane++)
+    {
+        const string &text = puzzles[lane];
+        int cell = 0;
+        for (size_t i = 0; i < text.size() && cell < 81; i++)
+        {
+            if (isspace((unsigned char)text[i]))
+                continue;
+            int digit = SudokuBoard::symbolToDigit(text[i], 9);
+            if (digit != Blank)
+                cand[cell][lane] = 1 << (digit - 1);
+            cell++;
+        }
+    }
+
+    LaneMask dead;
+    propagateLanes(cand, dead);
+    long long share = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count() /
+                      max(count, 1);
+
+    int fallbacks = 0;
+    for (int lane = 0; lane < count; lane++)
+    {
+        // results are reused from puzzle to puzzle: every field starts over, only the storage of the
+        // solution text is kept
+        PuzzleResult &result = results[lane];
+        string storage;
+        storage.swap(result.solution);
+        result = PuzzleResult();
+        result.solution.swap(storage);
+        result.recursiveCount = 1;
+        result.nanos = share;
+
+        bool contradiction = dead[lane] != 0;
+        bool finished = true;
+        // the lane's text is built in the result
+        string &cells = result.solution;
+        cells.assign(81, '.');
+        for (int cell = 0; cell < 81; cell++)
+        {
+            uint16_t v = cand[cell][lane];
+            if (v == 0)
+                contradiction = true;
+            else if ((v & (v - 1)) == 0)
+                cells[cell] = SudokuBoard::digitToSymbol(__builtin_ctz(v) + 1);
+            else
+                finished = false;
+        }
+
+        if (contradiction)
+        {
+            board.initializeBoard(puzzles[lane]);
+            result.solved = false;
+            board.toString(result.solution);
+        }
+        else if (finished)
+        {
+            result.solved = true;
+        }
+        else
+        {
+            fallbacks++;
+            board.initializeBoard(cells);
+            BatchSolver::solveBoard(board, NULL, result, NULL, 0, 0, NULL, budget);
+            result.nanos += share;
+        }
+    }
+    return fallbacks;
+}
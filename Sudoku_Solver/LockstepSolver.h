@@ -0,0 +1,61 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author          :Ajinkya Joshi, Anthony Chamoun
+* Date            :March 15th, 2023
+* File name       :LockstepSolver.h
+* Purpose         :Propagates singles on a group of 9 x 9 boards at once
+*                  with vector instructions, falling back to solveSudoku
+*                  for the boards that need branching.
+ **************************************************************************/
+
+#ifndef LOCKSTEPSOLVER_H
+#define LOCKSTEPSOLVER_H
+#include <string>
+#include "SudokuBoard.h"
+#include "BatchSolver.h"
+
+using namespace std;
+
+class LockstepSolver
+{
+
+/*
+ * The candidates of a group are kept cell by cell, each cell holding the masks of all the boards side by side
+ * (structure of arrays), so one vector operation updates the same cell of every board. Naked and hidden
+ * singles run on every board of the group until none of them changes. The kernel is compiled for AVX2 and for
+ * the baseline instruction set and the wider one is picked at load time when the CPU has it.
+*/
+private:
+    SudokuBoard board; // solves the boards the singles leave unfinished
+    SearchBudget budget; // limits of the fallback search
+
+public:
+    static const int Lanes = 16; // boards solved together
+
+    /**
+    * Creates a solver whose fallback board uses the given settings.
+    * @param order Branching heuristic of the fallback search.
+    * @param propagate True to propagate at every node of the fallback search.
+    * @param limits Limits after which the fallback search gives up.
+    */
+    LockstepSolver(SelectionOrder order = MinRemaining, bool propagate = true, SearchBudget limits = SearchBudget());
+
+    /**
+    * Solves a group of 9 x 9 puzzles. Boards finished by singles alone report one recursive call and no
+    * backtracks; the others report the counters of the fallback search. Every board is charged an equal
+    * share of the group's propagation time.
+    * @param puzzles The puzzles, one character per cell as accepted by initializeBoard.
+    * @param count The number of puzzles, at most Lanes.
+    * @param results Receives one result per puzzle.
+    * @return The number of puzzles that needed the fallback search.
+    */
+    int solve(const string* puzzles, int count, PuzzleResult* results);
+
+    /**
+    * Names the instruction set the kernel runs with on this CPU.
+    * @return "avx2", "sse2" or "generic".
+    */
+    static const char* instructionSet();
+};
+
+#endif
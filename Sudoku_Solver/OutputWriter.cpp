@@ -0,0 +1,181 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author : Ajinkya Joshi, Anthony Chamoun
+* Date : March 15, 2023
+* File name : OutputWriter.cpp - Buffered solver output
+* Purpose : Collects output in one buffer and writes it out in large blocks
+****************************************************************************/
+
+#include "OutputWriter.h"
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+/**************************************************************************
+ * Constructor / Destructor
+****************************************************************************/
+
+
+/**
+ * Allocates the buffer.
+ * @param capacity: Size of the buffer in bytes
+*/
+OutputWriter::OutputWriter(size_t capacity) : buffer(max(capacity, (size_t)64)), used(0), fileTarget(-1)
+{
+}
+
+/**
+ * Writes whatever is left and closes the file.
+*/
+OutputWriter::~OutputWriter()
+{
+    flush();
+    if (fileTarget >= 0)
+        close(fileTarget);
+}
+
+
+/**************************************************************************
+ * Targets
+****************************************************************************/
+
+/**
+ * Opens the output file as a target.
+ * @param path the file to create
+ * @return false if the file cannot be created
+*/
+bool OutputWriter::open(const string &path)
+{
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return false;
+    flush();
+    if (fileTarget >= 0)
+    {
+        targets.erase(find(targets.begin(), targets.end(), fileTarget));
+        close(fileTarget);
+    }
+    fileTarget = fd;
+    targets.push_back(fd);
+    return true;
+}
+
+/**
+ * Adds or removes standard output.
+ * @param enabled true to write to the console as well
+*/
+void OutputWriter::echo(bool enabled)
+{
+    flush();
+    vector<int>::iterator it = find(targets.begin(), targets.end(), (int)STDOUT_FILENO);
+    if (enabled && it == targets.end())
+        targets.push_back(STDOUT_FILENO);
+    else if (!enabled && it != targets.end())
+        targets.erase(it);
+}
+
+/**
+ * Writes a block to every target.
+ * @param text the bytes
+ * @param length the number of bytes
+*/
+void OutputWriter::send(const char* text, size_t length)
+{
+    for (int i = 0; i < (int)targets.size(); i++)
+    {
+        size_t done = 0;
+        while (done < length)
+        {
+            ssize_t n = ::write(targets[i], text + done, length - done);
+            if (n <= 0)
+                break;
+            done += n;
+        }
+    }
+}
+
+/**
+ * Empties the buffer into the targets.
+*/
+void OutputWriter::flush()
+{
+    if (used > 0)
+        send(buffer.data(), used);
+    used = 0;
+}
+
+
+/**************************************************************************
+ * Appending
+****************************************************************************/
+
+/**
+ * Copies bytes into the buffer, flushing first when they do not fit. Blocks larger than the buffer are
+ * written through directly.
+ * @param text the bytes
+ * @param length the number of bytes
+*/
+void OutputWriter::write(const char* text, size_t length)
+{
+    if (used + length > buffer.size())
+    {
+        flush();
+        if (length > buffer.size())
+        {
+            send(text, length);
+            return;
+        }
+    }
+    memcpy(buffer.data() + used, text, length);
+    used += length;
+}
+
+OutputWriter& OutputWriter::operator<<(const char* text)
+{
+    write(text, strlen(text));
+    return *this;
+}
+
+OutputWriter& OutputWriter::operator<<(const string &text)
+{
+    write(text.data(), text.size());
+    return *this;
+}
+
+OutputWriter& OutputWriter::operator<<(char ch)
+{
+    if (used == buffer.size())
+        flush();
+    buffer[used++] = ch;
+    return *this;
+}
+
+OutputWriter& OutputWriter::operator<<(int value)
+{
+    return *this << (long long)value;
+}
+
+OutputWriter& OutputWriter::operator<<(long long value)
+{
+    char digits[24];
+    int length = snprintf(digits, sizeof(digits), "%lld", value);
+    write(digits, length);
+    return *this;
+}
+
+/**
+ * Appends a number in the default ostream notation.
+ * @param value the number
+ * @return the writer
+*/
+OutputWriter& OutputWriter::operator<<(double value)
+{
+    char digits[32];
+    int length = snprintf(digits, sizeof(digits), "%g", value);
+    write(digits, length);
+    return *this;
+}
@@ -0,0 +1,99 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author          :Ajinkya Joshi, Anthony Chamoun
+* Date            :March 15th, 2023
+* File name       :OutputWriter.h
+* Purpose         :Large buffered writer that sends the solver output to
+*                  the output file and, optionally, the console.
+ **************************************************************************/
+
+#ifndef OUTPUTWRITER_H
+#define OUTPUTWRITER_H
+#include <string>
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+/**
+* What the solver writes for each puzzle.
+* Full prints every board, its conflict tables, the solution and the counters (the original output).
+* Quiet prints only the summary. Compact prints one line per puzzle holding the final board.
+* Csv and JsonLines print one record per puzzle with its counters and solve time.
+*/
+enum OutputMode { Full, Quiet, Compact, Csv, JsonLines };
+
+class OutputWriter
+{
+
+/*
+ * Everything is appended to one buffer and only handed to the operating system when the buffer is full, on
+ * flush() and on destruction. Every target receives the same bytes, so the console copy costs one more
+ * write call per buffer rather than a second formatting pass.
+*/
+private:
+    vector<char> buffer;
+    size_t used; // bytes waiting in buffer
+    vector<int> targets; // file descriptors receiving the output
+    int fileTarget; // descriptor opened by open, -1 if none
+
+    /**
+    * Writes a block to every target, retrying short writes.
+    * @param text The bytes to write.
+    * @param length The number of bytes.
+    */
+    void send(const char* text, size_t length);
+
+public:
+
+    /**
+    * Creates a writer without targets.
+    * @param capacity Size of the buffer in bytes.
+    */
+    OutputWriter(size_t capacity = 1 << 20);
+
+    /**
+    * Flushes and closes the output file.
+    */
+    ~OutputWriter();
+
+    /**
+    * Creates or truncates a file and adds it as a target.
+    * @param path The file to write.
+    * @return False if the file cannot be created.
+    */
+    bool open(const string &path);
+
+    /**
+    * Adds or removes standard output as a target.
+    * @param enabled True to copy the output to the console.
+    */
+    void echo(bool enabled);
+
+    /**
+    * Hands the buffered bytes to every target.
+    */
+    void flush();
+
+    /**
+    * Appends bytes to the buffer.
+    * @param text The bytes.
+    * @param length The number of bytes.
+    */
+    void write(const char* text, size_t length);
+
+    OutputWriter& operator<<(const char* text);
+    OutputWriter& operator<<(const string &text);
+    OutputWriter& operator<<(char ch);
+    OutputWriter& operator<<(int value);
+    OutputWriter& operator<<(long long value);
+
+    /**
+    * Appends a floating point number formatted like an ostream with default settings (printf "%g").
+    * @param value The number.
+    * @return The writer.
+    */
+    OutputWriter& operator<<(double value);
+};
+
+#endif
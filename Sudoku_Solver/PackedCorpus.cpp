@@ -0,0 +1,312 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author : Ajinkya Joshi, Anthony Chamoun
+* Date : March 15, 2023
+* File name : PackedCorpus.cpp - Binary puzzle archives
+* Purpose : Packs puzzles, solutions and counters into fixed-size records
+****************************************************************************/
+
+#include "PackedCorpus.h"
+#include "SudokuBoard.h"
+#include <cstring>
+
+using namespace std;
+
+// bytes of the counters at the end of a record with PackedHasStats: status, recursive calls, backtracks, nanos
+static const size_t StatsBytes = 1 + 4 + 4 + 8;
+
+// bits of the status byte of the counters
+static const uint8_t StatusSolved = 1;
+static const uint8_t StatusGaveUp = 2;
+
+/**
+ * Stores the low bytes of a value, least significant first, whatever the byte order of the host.
+ * @param bytes: Receives the value
+ * @param value: The value
+ * @param size: The bytes to store
+*/
+static void putLittleEndian(uint8_t* bytes, uint64_t value, int size)
+{
+    for (int i = 0; i < size; i++)
+        bytes[i] = (uint8_t)(value >> (8 * i));
+}
+
+/**
+ * Reads a value stored by putLittleEndian.
+ * @param bytes: The stored value
+ * @param size: The bytes it takes
+ * @return the value
+*/
+static uint64_t getLittleEndian(const uint8_t* bytes, int size)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < size; i++)
+        value |= (uint64_t)bytes[i] << (8 * i);
+    return value;
+}
+
+/**************************************************************************
+ * Cells
+****************************************************************************/
+
+/**
+ * Returns the narrowest width holding every digit of the board and 0 for a blank.
+ * @param N: The size of the board
+ * @return the bits per cell
+*/
+int packedCellBits(int N)
+{
+    int bits = 1;
+    while ((1 << bits) <= N)
+        bits++;
+    return bits;
+}
+
+/**
+ * Rounds the bits of the cells up to whole bytes.
+ * @param N: The size of the board
+ * @return the bytes of the bit field
+*/
+size_t packedBoardBytes(int N)
+{
+    return ((size_t)N * N * packedCellBits(N) + 7) / 8;
+}
+
+/**
+ * Adds the optional parts to the packed puzzle.
+ * @param N: The size of the board
+ * @param flags: The optional parts
+ * @return the bytes per record
+*/
+size_t packedRecordSize(int N, int flags)
+{
+    size_t size = packedBoardBytes(N);
+    if (flags & PackedHasSolutions)
+        size += packedBoardBytes(N);
+    if (flags & PackedHasStats)
+        size += StatsBytes;
+    return size;
+}
+
+/**
+ * Writes the digits of the cells one after the other, least significant bit first.
+ * @param text: The symbols
+ * @param N: The size of the board
+ * @param out: Receives the bit field
+*/
+void packCells(const char* text, int N, uint8_t* out)
+{
+    int bits = packedCellBits(N);
+    memset(out, 0, packedBoardBytes(N));
+    size_t pos = 0;
+    for (int cell = 0; cell < N * N; cell++, pos += bits)
+    {
+        unsigned digit = SudokuBoard::symbolToDigit(text[cell], N);
+        // a cell never spans more than two bytes, since it has at most 6 bits
+        out[pos / 8] |= (uint8_t)(digit << (pos % 8));
+        if (pos % 8 + bits > 8)
+            out[pos / 8 + 1] |= (uint8_t)(digit >> (8 - pos % 8));
+    }
+}
+
+/**
+ * Reads the digits back in the order packCells wrote them, feeding whole bytes into a bit buffer instead of
+ * locating every cell from its bit position.
+ * @param in: The bit field
+ * @param N: The size of the board
+ * @param digits: Receives the digits
+*/
+void unpackDigits(const uint8_t* in, int N, uint8_t* digits)
+{
+    int bits = packedCellBits(N);
+    unsigned mask = (1u << bits) - 1;
+    unsigned buffer = 0;
+    int held = 0; // bits in the buffer
+    for (int cell = 0; cell < N * N; cell++)
+    {
+        if (held < bits)
+        {
+            buffer |= (unsigned)*in++ << held;
+            held += 8;
+        }
+        digits[cell] = buffer & mask;
+        buffer >>= bits;
+        held -= bits;
+    }
+}
+
+/**
+ * Unpacks the digits and turns them into symbols.
+ * @param in: The bit field
+ * @param N: The size of the board
+ * @param text: Receives the symbols
+*/
+void unpackCells(const uint8_t* in, int N, char* text)
+{
+    uint8_t digits[36 * 36];
+    unpackDigits(in, N, digits);
+    for (int cell = 0; cell < N * N; cell++)
+        text[cell] = SudokuBoard::digitToSymbol(digits[cell]);
+}
+
+/**
+ * Decodes the counters written by PackedWriter::write.
+ * @param record: The start of the record
+ * @param N: The size of the board
+ * @param flags: The flags of the file
+ * @return the counters
+*/
+PackedStats unpackStats(const uint8_t* record, int N, int flags)
+{
+    const uint8_t* bytes = record + packedRecordSize(N, flags) - StatsBytes;
+    PackedStats stats;
+    stats.solved = (bytes[0] & StatusSolved) != 0;
+    stats.gaveUp = (bytes[0] & StatusGaveUp) != 0;
+    stats.recursiveCount = (int32_t)getLittleEndian(bytes + 1, 4);
+    stats.backtracksCount = (int32_t)getLittleEndian(bytes + 5, 4);
+    stats.nanos = (int64_t)getLittleEndian(bytes + 9, 8);
+    return stats;
+}
+
+/**
+ * Lays the header out field by field, in the order of the struct.
+ * @param header: The header
+ * @param bytes: Receives sizeof(PackedHeader) bytes
+*/
+void encodeHeader(const PackedHeader &header, uint8_t* bytes)
+{
+    memcpy(bytes, header.magic, sizeof(header.magic));
+    putLittleEndian(bytes + 8, header.version, 4);
+    putLittleEndian(bytes + 12, header.boardSize, 2);
+    putLittleEndian(bytes + 14, header.flags, 2);
+    putLittleEndian(bytes + 16, header.recordSize, 4);
+    putLittleEndian(bytes + 20, header.reserved, 4);
+    putLittleEndian(bytes + 24, header.count, 8);
+}
+
+/**
+ * Reads the fields back in the order encodeHeader wrote them.
+ * @param bytes: The start of the file
+ * @param header: Receives the header
+*/
+void decodeHeader(const uint8_t* bytes, PackedHeader &header)
+{
+    memcpy(header.magic, bytes, sizeof(header.magic));
+    header.version = getLittleEndian(bytes + 8, 4);
+    header.boardSize = getLittleEndian(bytes + 12, 2);
+    header.flags = getLittleEndian(bytes + 14, 2);
+    header.recordSize = getLittleEndian(bytes + 16, 4);
+    header.reserved = getLittleEndian(bytes + 20, 4);
+    header.count = getLittleEndian(bytes + 24, 8);
+}
+
+
+/**************************************************************************
+ * Writer
+****************************************************************************/
+
+/**
+ * Creates a writer with no file.
+*/
+PackedWriter::PackedWriter()
+{
+    memset(&header, 0, sizeof(header));
+}
+
+/**
+ * Finishes the file if it was left open.
+*/
+PackedWriter::~PackedWriter()
+{
+    close();
+}
+
+/**
+ * Creates the file and writes a header with no records yet.
+ * @param path: The file to write
+ * @param N: The size of the boards
+ * @param flags: The optional parts of every record
+ * @return false if the file cannot be created
+*/
+bool PackedWriter::open(const string &path, int N, int flags)
+{
+    close();
+    out.open(path, ios::binary | ios::trunc);
+    if (!out.is_open())
+        return false;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PackedMagic, sizeof(header.magic));
+    header.version = PackedVersion;
+    header.boardSize = N;
+    header.flags = flags;
+    header.recordSize = packedRecordSize(N, flags);
+    uint8_t bytes[sizeof(PackedHeader)];
+    encodeHeader(header, bytes);
+    out.write((const char*)bytes, sizeof(bytes));
+    record.assign(header.recordSize, '\0');
+    return out.good();
+}
+
+/**
+ * Packs a puzzle and its optional parts into the record buffer and appends it.
+ * @param puzzle: The puzzle
+ * @param solution: The solved board
+ * @param stats: The counters of the solve
+*/
+void PackedWriter::write(const string &puzzle, const string &solution, const PackedStats &stats)
+{
+    int N = header.boardSize;
+    size_t cells = (size_t)N * N;
+    if (!out.is_open() || puzzle.size() < cells)
+        return;
+
+    uint8_t* bytes = (uint8_t*)&record[0];
+    packCells(puzzle.data(), N, bytes);
+    bytes += packedBoardBytes(N);
+    if (header.flags & PackedHasSolutions)
+    {
+        // a board that was never solved is kept as an empty grid
+        if (solution.size() >= cells)
+            packCells(solution.data(), N, bytes);
+        else
+            memset(bytes, 0, packedBoardBytes(N));
+        bytes += packedBoardBytes(N);
+    }
+    if (header.flags & PackedHasStats)
+    {
+        // a count cut short by its budget can be both solved and given up
+        bytes[0] = (stats.solved ? StatusSolved : 0) | (stats.gaveUp ? StatusGaveUp : 0);
+        putLittleEndian(bytes + 1, (uint32_t)stats.recursiveCount, 4);
+        putLittleEndian(bytes + 5, (uint32_t)stats.backtracksCount, 4);
+        putLittleEndian(bytes + 9, (uint64_t)stats.nanos, 8);
+    }
+    out.write(record.data(), record.size());
+    header.count++;
+}
+
+/**
+ * Rewrites the header with the final count.
+ * @return false if a write failed
+*/
+bool PackedWriter::close()
+{
+    if (!out.is_open())
+        return true;
+    uint8_t bytes[sizeof(PackedHeader)];
+    encodeHeader(header, bytes);
+    out.seekp(0);
+    out.write((const char*)bytes, sizeof(bytes));
+    bool good = out.good();
+    out.close();
+    return good;
+}
+
+/**
+ * Returns the number of records written.
+ * @return the record count
+*/
+long long PackedWriter::size()
+{
+    return header.count;
+}
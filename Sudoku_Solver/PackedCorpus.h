@@ -0,0 +1,180 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author          :Ajinkya Joshi, Anthony Chamoun
+* Date            :March 15th, 2023
+* File name       :PackedCorpus.h
+* Purpose         :Binary puzzle archives with fixed-size records, a few
+*                  bits per cell, and optionally the solution and the
+*                  search counters of every puzzle.
+ **************************************************************************/
+
+#ifndef PACKEDCORPUS_H
+#define PACKEDCORPUS_H
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include <cstddef>
+
+using namespace std;
+
+/**
+* Optional parts of a packed record.
+*/
+enum PackedFlags { PackedHasSolutions = 1, PackedHasStats = 2 };
+
+/**
+* The 32 bytes at the start of a packed file. The fields are stored one after the other, little-endian, by
+* encodeHeader, never by copying the struct, so a file reads the same on any host. Record i starts at
+* sizeof(PackedHeader) + i * recordSize, so any puzzle is found without reading the ones before it.
+*/
+struct PackedHeader
+{
+    char magic[8]; // PackedMagic
+    uint32_t version;
+    uint16_t boardSize;
+    uint16_t flags; // PackedFlags
+    uint32_t recordSize; // bytes per record
+    uint32_t reserved;
+    uint64_t count; // number of records
+};
+
+/**
+* Search counters kept with a puzzle when the file has PackedHasStats; integers are stored little-endian.
+*/
+struct PackedStats
+{
+    bool solved = false;
+    bool gaveUp = false;
+    int recursiveCount = 0; // recursive calls, including the initial call
+    int backtracksCount = 0;
+    long long nanos = 0; // wall time of the search
+};
+
+const char PackedMagic[8] = { 'S', 'U', 'D', 'O', 'K', 'U', 'P', 'K' };
+const uint32_t PackedVersion = 1;
+
+/**
+* Returns the bits a cell takes in a packed record, the fewest that hold 0 to N: 4 for 9 x 9 boards, 5 for
+* 16 x 16 and 25 x 25, 6 for 36 x 36.
+* @param N The size of the board.
+* @return The bits per cell.
+*/
+int packedCellBits(int N);
+
+/**
+* Returns the bytes one packed board takes; a record holds the puzzle first, then the solution, if any.
+* @param N The size of the board.
+* @return The bytes of the bit field.
+*/
+size_t packedBoardBytes(int N);
+
+/**
+* Returns the size of a record.
+* @param N The size of the board.
+* @param flags The optional parts, PackedFlags or-ed together.
+* @return The bytes per record.
+*/
+size_t packedRecordSize(int N, int flags);
+
+/**
+* Packs board text, one symbol per cell as in SudokuBoard::toString, into a bit field; blanks are 0.
+* @param text The N x N symbols; whitespace is not allowed.
+* @param N The size of the board.
+* @param out Receives the packed cells, (N * N * packedCellBits(N) + 7) / 8 bytes.
+*/
+void packCells(const char* text, int N, uint8_t* out);
+
+/**
+* Unpacks a bit field to one digit per cell, 0 for blanks, ready for SudokuBoard::initializeDigits.
+* @param in The packed cells.
+* @param N The size of the board.
+* @param digits Receives the N x N digits.
+*/
+void unpackDigits(const uint8_t* in, int N, uint8_t* digits);
+
+/**
+* Unpacks a bit field back to board text, '.' for blanks.
+* @param in The packed cells.
+* @param N The size of the board.
+* @param text Receives the N x N symbols.
+*/
+void unpackCells(const uint8_t* in, int N, char* text);
+
+/**
+* Writes a header in the byte layout of packed files.
+* @param header The header.
+* @param bytes Receives sizeof(PackedHeader) bytes.
+*/
+void encodeHeader(const PackedHeader &header, uint8_t* bytes);
+
+/**
+* Reads a header written by encodeHeader.
+* @param bytes The first sizeof(PackedHeader) bytes of the file.
+* @param header Receives the header.
+*/
+void decodeHeader(const uint8_t* bytes, PackedHeader &header);
+
+/**
+* Reads the counters stored at the end of a record with PackedHasStats.
+* @param record The start of the record.
+* @param N The size of the board.
+* @param flags The flags of the file.
+* @return The counters.
+*/
+PackedStats unpackStats(const uint8_t* record, int N, int flags);
+
+class PackedWriter
+{
+
+/*
+ * Records are written as they come and the header is written twice: once with a count of 0 when the file is
+ * opened, so a file cut short is recognizably incomplete, and again with the real count on close.
+*/
+private:
+    ofstream out;
+    PackedHeader header;
+    string record; // the record being built, reused for every puzzle
+
+public:
+
+    /**
+    * Creates a writer with no file open.
+    */
+    PackedWriter();
+
+    /**
+    * Closes the file if one is open.
+    */
+    ~PackedWriter();
+
+    /**
+    * Creates a packed file.
+    * @param path The file to write.
+    * @param N The size of the boards.
+    * @param flags The optional parts every record carries.
+    * @return False if the file cannot be created.
+    */
+    bool open(const string &path, int N, int flags);
+
+    /**
+    * Appends one puzzle.
+    * @param puzzle The puzzle, N x N symbols.
+    * @param solution The board after solving, N x N symbols; ignored without PackedHasSolutions.
+    * @param stats The counters of the solve; ignored without PackedHasStats.
+    */
+    void write(const string &puzzle, const string &solution = string(), const PackedStats &stats = PackedStats());
+
+    /**
+    * Writes the final header and closes the file.
+    * @return False if anything could not be written.
+    */
+    bool close();
+
+    /**
+    * Returns the number of puzzles written so far.
+    * @return The record count.
+    */
+    long long size();
+};
+
+#endif
@@ -0,0 +1,115 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author : Ajinkya Joshi, Anthony Chamoun
+* Date : March 15, 2023
+* File name : PerfCounters.cpp - Hardware counters of the calling thread
+* Purpose : Wraps perf_event_open for the instrumented builds
+****************************************************************************/
+
+#include "PerfCounters.h"
+#include <cstring>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+using namespace std;
+
+/**************************************************************************
+ * Constructor / Destructor
+****************************************************************************/
+
+
+/**
+ * Opens one counter per event for the calling thread, on any CPU, user mode only.
+*/
+PerfCounters::PerfCounters()
+{
+    for (int i = 0; i < Events; i++)
+        fds[i] = -1;
+#ifdef __linux__
+    const unsigned long long configs[Events] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                PERF_COUNT_HW_BRANCH_MISSES};
+    for (int i = 0; i < Events; i++)
+    {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[i];
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fds[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+#endif
+}
+
+/**
+ * Closes the counters that were opened.
+*/
+PerfCounters::~PerfCounters()
+{
+#ifdef __linux__
+    for (int i = 0; i < Events; i++)
+        if (fds[i] >= 0)
+            close(fds[i]);
+#endif
+}
+
+
+/**************************************************************************
+ * Counting
+****************************************************************************/
+
+/**
+ * Tells whether any counter could be opened.
+ * @return True if at least one event is counted.
+*/
+bool PerfCounters::available()
+{
+    for (int i = 0; i < Events; i++)
+        if (fds[i] >= 0)
+            return true;
+    return false;
+}
+
+/**
+ * Resets and starts the counters.
+*/
+void PerfCounters::start()
+{
+#ifdef __linux__
+    for (int i = 0; i < Events; i++)
+    {
+        if (fds[i] < 0)
+            continue;
+        ioctl(fds[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(fds[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+/**
+ * Stops the counters and stores their values.
+ * @param profile Receives the counts.
+*/
+void PerfCounters::stop(SearchProfile &profile)
+{
+#ifdef __linux__
+    long long* fields[Events] = {&profile.cycles, &profile.instructions, &profile.branchMisses};
+    for (int i = 0; i < Events; i++)
+    {
+        if (fds[i] < 0)
+            continue;
+        ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0);
+        long long value;
+        if (read(fds[i], &value, sizeof(value)) == (ssize_t)sizeof(value))
+            *fields[i] = value;
+    }
+#else
+    (void)profile;
+#endif
+}
@@ -0,0 +1,58 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author          :Ajinkya Joshi, Anthony Chamoun
+* Date            :March 15th, 2023
+* File name       :PerfCounters.h
+* Purpose         :Reads the CPU's cycle, instruction and branch miss
+*                  counters for the calling thread around a search.
+ **************************************************************************/
+
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+#include "SudokuCore.h"
+
+using namespace std;
+
+class PerfCounters
+{
+
+/*
+ * The counters come from perf_event_open on Linux, counting user-mode events of the thread that opened them,
+ * so every worker opens its own set. When the kernel refuses (no support, perf_event_paranoid, a container)
+ * or on other systems the counters are simply unavailable and the profile keeps -1.
+*/
+private:
+    static const int Events = 3; // cycles, instructions, branch misses
+    int fds[Events]; // one file descriptor per event, -1 when it could not be opened
+
+public:
+
+    /**
+    * Opens the counters for the calling thread.
+    */
+    PerfCounters();
+
+    /**
+    * Closes the counters.
+    */
+    ~PerfCounters();
+
+    /**
+    * Tells whether any counter could be opened.
+    * @return True if at least one event is counted.
+    */
+    bool available();
+
+    /**
+    * Resets and starts the counters.
+    */
+    void start();
+
+    /**
+    * Stops the counters and stores their values.
+    * @param profile Receives the cycles, instructions and branch misses; unavailable ones are left as they are.
+    */
+    void stop(SearchProfile &profile);
+};
+
+#endif
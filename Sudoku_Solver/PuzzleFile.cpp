@@ -0,0 +1,353 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author : Ajinkya Joshi, Anthony Chamoun
+* Date : March 15, 2023
+* File name : PuzzleFile.cpp - Memory mapped puzzle input
+* Purpose : Indexes a puzzle file once and loads puzzles from the mapping
+****************************************************************************/
+
+#include "PuzzleFile.h"
+#include <cstring>
+#include <algorithm>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+/**
+ * True for the whitespace that may separate cells in a puzzle file.
+ * @param ch the character
+ * @return true if ch is a space, tab or line break
+*/
+static inline bool isGap(char ch)
+{
+    return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t' || ch == '\f' || ch == '\v';
+}
+
+/**************************************************************************
+ * Constructor / Destructor
+****************************************************************************/
+
+
+/**
+ * Creates a closed puzzle file.
+ * @param N: The size of the boards
+*/
+PuzzleFile::PuzzleFile(int N) : boardSize(N), format(Grid), data(NULL), length(0), recordCount(0), cursor(0)
+{
+}
+
+/**
+ * Unmaps the file if one is open.
+*/
+PuzzleFile::~PuzzleFile()
+{
+    close();
+}
+
+
+/**************************************************************************
+ * Opening and indexing
+****************************************************************************/
+
+/**
+ * Maps the whole file read-only and builds the puzzle index.
+ * @param path the file to open
+ * @return false if the file cannot be opened or mapped
+*/
+bool PuzzleFile::open(const string &path)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    // an empty file cannot be mapped, but it is a valid file without puzzles
+    if (info.st_size > 0)
+    {
+        void* mapping = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED)
+        {
+            ::close(fd);
+            return false;
+        }
+        data = (const char*)mapping;
+        length = info.st_size;
+        // the index is built front to back, and puzzles are mostly loaded in order after that
+        madvise(mapping, length, MADV_SEQUENTIAL);
+    }
+    ::close(fd); // the mapping stays valid without the descriptor
+
+    if (length >= sizeof(PackedHeader) && memcmp(data, PackedMagic, sizeof(PackedMagic)) == 0)
+    {
+        format = Packed;
+        if (!readHeader())
+        {
+            close();
+            return false;
+        }
+        // workers seek straight to their ranges, so read-ahead of the whole file does not pay
+        madvise((void*)data, length, MADV_NORMAL);
+        return true;
+    }
+    format = detectFormat();
+    if (format == Line)
+        indexLines();
+    else
+        indexGrid();
+    return true;
+}
+
+/**
+ * Unmaps the file and clears the index.
+*/
+void PuzzleFile::close()
+{
+    if (data != NULL)
+        munmap((void*)data, length);
+    data = NULL;
+    length = 0;
+    starts.clear();
+    recordCount = 0;
+    cursor = 0;
+}
+
+/**
+ * Looks at the first line with content: a puzzle line starts with N x N cells and no whitespace between them.
+ * @return the detected format
+*/
+PuzzleFormat PuzzleFile::detectFormat()
+{
+    size_t pos = 0;
+    while (pos < length)
+    {
+        const char* end = (const char*)memchr(data + pos, '\n', length - pos);
+        size_t lineEnd = (end != NULL) ? end - data : length;
+
+        size_t first = pos;
+        while (first < lineEnd && isGap(data[first]))
+            first++;
+        if (first < lineEnd && data[first] != '#')
+        {
+            size_t run = 0;
+            while (first + run < lineEnd && !isGap(data[first + run]))
+                run++;
+            return (run >= (size_t)(boardSize * boardSize)) ? Line : Grid;
+        }
+        pos = lineEnd + 1;
+    }
+    return Grid;
+}
+
+/**
+ * Walks the file counting cell characters. 'Z' only ends the file in place of a new puzzle, since it is a
+ * digit on large boards, and a trailing partial puzzle is dropped.
+*/
+void PuzzleFile::indexGrid()
+{
+    size_t cells = boardSize * boardSize;
+    size_t pos = 0;
+    while (pos < length)
+    {
+        while (pos < length && isGap(data[pos]))
+            pos++;
+        if (pos == length || data[pos] == 'Z')
+            break;
+
+        size_t start = pos;
+        size_t count = 0;
+        while (pos < length && count < cells)
+        {
+            if (!isGap(data[pos]))
+                count++;
+            pos++;
+        }
+        if (count == cells)
+            starts.push_back(start);
+    }
+}
+
+/**
+ * Checks the header against the board size and the file length. A file whose writer did not finish has a
+ * count of 0 and opens as an empty file.
+ * @return false if the file cannot be read as packed puzzles of this size
+*/
+bool PuzzleFile::readHeader()
+{
+    decodeHeader((const uint8_t*)data, header);
+    if (header.version != PackedVersion || header.boardSize != boardSize ||
+        header.recordSize != packedRecordSize(boardSize, header.flags))
+        return false;
+    size_t available = (length - sizeof(header)) / header.recordSize;
+    recordCount = (int)min((size_t)header.count, available);
+    return true;
+}
+
+/**
+ * Finds a record by arithmetic.
+ * @param index the puzzle
+ * @return the start of its record
+*/
+const uint8_t* PuzzleFile::record(int index)
+{
+    return (const uint8_t*)data + sizeof(header) + (size_t)index * header.recordSize;
+}
+
+/**
+ * Jumps from line to line with memchr and keeps every line holding a whole puzzle. Cells may be separated by
+ * whitespace, as loading skips it, so they are counted, up to a '#' comment; a line with fewer is skipped,
+ * since loading it would take its last cells from the next line.
+*/
+void PuzzleFile::indexLines()
+{
+    size_t cells = boardSize * boardSize;
+    size_t pos = 0;
+    while (pos < length)
+    {
+        const char* end = (const char*)memchr(data + pos, '\n', length - pos);
+        size_t lineEnd = (end != NULL) ? end - data : length;
+
+        while (pos < lineEnd && isGap(data[pos]))
+            pos++;
+        if (pos < lineEnd && data[pos] == 'Z' && lineEnd - pos < cells)
+            break;
+        if (lineEnd - pos >= cells && data[pos] != '#')
+        {
+            size_t found = 0;
+            for (size_t at = pos; at < lineEnd && found < cells && data[at] != '#'; at++)
+                if (!isGap(data[at]))
+                    found++;
+            if (found == cells)
+                starts.push_back(pos);
+        }
+        pos = lineEnd + 1;
+    }
+}
+
+
+/**************************************************************************
+ * Access
+****************************************************************************/
+
+/**
+ * Returns the detected format.
+ * @return the file format
+*/
+PuzzleFormat PuzzleFile::getFormat()
+{
+    return format;
+}
+
+/**
+ * Returns the number of puzzles found by the index.
+ * @return the number of puzzles
+*/
+int PuzzleFile::size()
+{
+    return (format == Packed) ? recordCount : starts.size();
+}
+
+/**
+ * Parses a puzzle directly from the mapping onto a board.
+ * @param index the puzzle
+ * @param board the board to load
+*/
+void PuzzleFile::load(int index, SudokuBoard &board)
+{
+    if (format == Packed)
+    {
+        uint8_t digits[36 * 36];
+        unpackDigits(record(index), boardSize, digits);
+        board.initializeDigits(digits);
+        return;
+    }
+    size_t start = starts[index];
+    board.initializeBoard(data + start, length - start);
+}
+
+/**
+ * Copies the cell characters of a puzzle.
+ * @param index the puzzle
+ * @return one character per cell
+*/
+string PuzzleFile::text(int index)
+{
+    size_t cells = boardSize * boardSize;
+    string puzzle;
+    if (format == Packed)
+    {
+        puzzle.resize(cells);
+        unpackCells(record(index), boardSize, &puzzle[0]);
+        return puzzle;
+    }
+    puzzle.reserve(cells);
+    for (size_t pos = starts[index]; pos < length && puzzle.size() < cells; pos++)
+        if (!isGap(data[pos]))
+            puzzle += data[pos];
+    return puzzle;
+}
+
+/**
+ * Unpacks the solution part of a record.
+ * @param index the puzzle
+ * @param cells receives the solution
+ * @return false if the file has no solutions
+*/
+bool PuzzleFile::storedSolution(int index, string &cells)
+{
+    if (format != Packed || !(header.flags & PackedHasSolutions))
+        return false;
+    cells.resize(boardSize * boardSize);
+    // the solution follows the puzzle
+    unpackCells(record(index) + packedBoardBytes(boardSize), boardSize, &cells[0]);
+    return true;
+}
+
+/**
+ * Decodes the counters part of a record.
+ * @param index the puzzle
+ * @param stats receives the counters
+ * @return false if the file has no counters
+*/
+bool PuzzleFile::storedStats(int index, PackedStats &stats)
+{
+    if (format != Packed || !(header.flags & PackedHasStats))
+        return false;
+    stats = unpackStats(record(index), boardSize, header.flags);
+    return true;
+}
+
+/**
+ * Moves the shared cursor forward by up to chunk puzzles.
+ * @param chunk the largest range to claim
+ * @param first set to the first index of the range
+ * @param last set to one past the end of the range
+ * @return false if nothing was left to claim
+*/
+bool PuzzleFile::claim(int chunk, int &first, int &last)
+{
+    int total = size();
+    first = cursor.fetch_add(chunk);
+    if (first >= total)
+        return false;
+    last = min(first + chunk, total);
+    return true;
+}
+
+/**
+ * Resets the shared cursor to the first puzzle.
+*/
+void PuzzleFile::rewind()
+{
+    cursor = 0;
+}
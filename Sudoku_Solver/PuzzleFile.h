@@ -0,0 +1,162 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author          :Ajinkya Joshi, Anthony Chamoun
+* Date            :March 15th, 2023
+* File name       :PuzzleFile.h
+* Purpose         :Maps a puzzle file into memory and loads puzzles from
+*                  it by index, without going through a stream.
+ **************************************************************************/
+
+#ifndef PUZZLEFILE_H
+#define PUZZLEFILE_H
+#include <vector>
+#include <string>
+#include <atomic>
+#include <cstddef>
+#include "SudokuBoard.h"
+#include "PackedCorpus.h"
+
+using namespace std;
+
+/**
+* Layout of a puzzle file.
+* Grid holds each puzzle as N x N symbols separated by any whitespace, ended by a 'Z' in place of a new
+* puzzle (the original input format). Line holds one puzzle per line, its first N x N characters being the
+* cells, possibly separated by spaces; anything after them on the line is ignored, as are empty lines, lines
+* starting with '#' and lines with fewer than N x N cells before a '#'.
+* Packed is the binary format written by PackedWriter, recognized by its header.
+*/
+enum PuzzleFormat { Grid, Line, Packed };
+
+class PuzzleFile
+{
+
+/*
+ * The file is mapped read-only and indexed in one pass that records where each puzzle starts. Loading a
+ * puzzle parses it straight from the mapping into a board, so puzzles are never copied into strings and any
+ * thread can load any puzzle. Workers share the file by claiming ranges of puzzle indices from an atomic
+ * cursor.
+*/
+private:
+    int boardSize;
+    PuzzleFormat format;
+    const char* data; // start of the mapping, NULL when nothing is open
+    size_t length; // size of the mapping in bytes
+    vector<size_t> starts; // offset of the first cell of every puzzle, empty for Packed
+    PackedHeader header; // the header of a Packed file
+    int recordCount; // number of puzzles in a Packed file
+    atomic<int> cursor; // first index not yet claimed
+
+    /**
+    * Guesses the layout from the first line that is not empty or a comment.
+    * @return Line if that line starts with N x N cell characters, Grid otherwise.
+    */
+    PuzzleFormat detectFormat();
+
+    /**
+    * Records the start of every complete puzzle in a Grid file.
+    */
+    void indexGrid();
+
+    /**
+    * Records the start of every puzzle line in a Line file.
+    */
+    void indexLines();
+
+    /**
+    * Reads the header of a Packed file. Nothing is indexed, since record i is at a fixed offset.
+    * @return False if the header is damaged or for another board size.
+    */
+    bool readHeader();
+
+    /**
+    * Returns the start of a record of a Packed file.
+    * @param index The puzzle.
+    * @return The first byte of its record.
+    */
+    const uint8_t* record(int index);
+
+public:
+
+    /**
+    * Creates a closed file for N x N boards.
+    * @param N The size of the boards.
+    */
+    PuzzleFile(int N);
+
+    /**
+    * Unmaps the file.
+    */
+    ~PuzzleFile();
+
+    /**
+    * Maps a file and indexes its puzzles. Any previously opened file is closed first.
+    * @param path The file to open.
+    * @return False if the file cannot be opened or mapped, or is a packed file of another board size.
+    */
+    bool open(const string &path);
+
+    /**
+    * Unmaps the file and forgets its index.
+    */
+    void close();
+
+    /**
+    * Returns the layout detected when the file was opened.
+    * @return The file format.
+    */
+    PuzzleFormat getFormat();
+
+    /**
+    * Returns the number of complete puzzles in the file.
+    * @return The number of puzzles.
+    */
+    int size();
+
+    /**
+    * Loads a puzzle onto a board. Safe to call from several threads with different boards.
+    * @param index The puzzle, from 0 to size() - 1.
+    * @param board The board to load; it must be N x N.
+    */
+    void load(int index, SudokuBoard &board);
+
+    /**
+    * Copies a puzzle out as one character per cell, in SudokuBoard::toString format except that blanks
+    * keep the character used in the file.
+    * @param index The puzzle, from 0 to size() - 1.
+    * @return The puzzle text.
+    */
+    string text(int index);
+
+    /**
+    * Returns the solution stored with a puzzle of a Packed file.
+    * @param index The puzzle, from 0 to size() - 1.
+    * @param cells Receives the solution, '.' in every cell if the puzzle was not solved.
+    * @return False if the file keeps no solutions.
+    */
+    bool storedSolution(int index, string &cells);
+
+    /**
+    * Returns the counters stored with a puzzle of a Packed file.
+    * @param index The puzzle, from 0 to size() - 1.
+    * @param stats Receives the counters.
+    * @return False if the file keeps no counters.
+    */
+    bool storedStats(int index, PackedStats &stats);
+
+    /**
+    * Claims the next range of puzzles not yet handed out. Safe to call from several threads.
+    * @param chunk The largest number of puzzles to claim.
+    * @param first Set to the first claimed index.
+    * @param last Set to one past the last claimed index.
+    * @return False once every puzzle has been claimed.
+    */
+    bool claim(int chunk, int &first, int &last);
+
+    /**
+    * Makes every puzzle available to claim again.
+    */
+    void rewind();
+};
+
+#endif
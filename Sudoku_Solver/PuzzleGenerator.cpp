@@ -0,0 +1,303 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author : Ajinkya Joshi, Anthony Chamoun
+* Date : March 15, 2023
+* File name : PuzzleGenerator.cpp - Random puzzles with a unique solution
+* Purpose : Fills random grids and removes clues while the solution stays
+*           unique, on a work-stealing pool, reporting in index order
+****************************************************************************/
+
+#include "PuzzleGenerator.h"
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+
+using namespace std;
+
+const int PuzzleGenerator::WindowChunks;
+
+/**
+ * Returns a uniformly chosen integer below n. Uses the raw generator output rather than a standard
+ * distribution, whose algorithm differs between libraries, so a seed gives the same puzzles everywhere.
+ * Outputs from the last, partial run of n values are drawn again, since taking them modulo n would favor
+ * the low results.
+ * @param rng the generator
+ * @param n the number of choices
+ * @return a value from 0 to n - 1
+*/
+static int pick(mt19937 &rng, int n)
+{
+    const uint64_t range = 1ULL << 32; // mt19937 gives 32 bits
+    uint64_t limit = range - range % n;
+    uint64_t value;
+    do
+        value = rng();
+    while (value >= limit);
+    return value % n;
+}
+
+/**
+ * Shuffles the first n entries of an array with the generator.
+ * @param values the array
+ * @param n the number of entries
+ * @param rng the generator
+*/
+static void shuffle(int* values, int n, mt19937 &rng)
+{
+    for (int i = n - 1; i > 0; i--)
+        swap(values[i], values[pick(rng, i + 1)]);
+}
+
+
+/**************************************************************************
+ * Constructor / Destructor
+****************************************************************************/
+
+
+/**
+ * Starts the pool and gives every worker a board of the requested size.
+ * @param threads: Number of workers, 0 for one per hardware thread
+ * @param opts: Settings applied to every puzzle
+*/
+PuzzleGenerator::PuzzleGenerator(int threads, GeneratorOptions opts) : options(opts), pool(threads)
+{
+    for (int i = 0; i < pool.size(); i++)
+        boards.push_back(new SudokuBoard(options.boardSize));
+}
+
+/**
+ * Frees the per-worker boards once the pool is idle.
+*/
+PuzzleGenerator::~PuzzleGenerator()
+{
+    pool.wait();
+    for (int i = 0; i < (int)boards.size(); i++)
+        delete boards[i];
+}
+
+
+/**************************************************************************
+ * Generating
+****************************************************************************/
+
+/**
+ * Returns the number of worker threads.
+ * @return The number of workers.
+*/
+int PuzzleGenerator::threadCount()
+{
+    return pool.size();
+}
+
+/**
+ * Returns the name of a difficulty band.
+ * @param difficulty The band.
+ * @return The lower-case name.
+*/
+const char* PuzzleGenerator::difficultyName(Difficulty difficulty)
+{
+    switch (difficulty)
+    {
+    case Easy:
+        return "easy";
+    case Medium:
+        return "medium";
+    case Hard:
+        return "hard";
+    default:
+        return "any";
+    }
+}
+
+/**
+ * Fills the squares on the diagonal, which never constrain each other, with random permutations and lets
+ * the solver complete the grid. The solver always completes it the same way, so the rows within each band,
+ * the bands, the columns within each stack and the stacks are then permuted and the grid transposed half
+ * the time.
+ * @param board The board to fill.
+ * @param rng The generator.
+ * @return The complete grid.
+*/
+string PuzzleGenerator::randomGrid(SudokuBoard &board, mt19937 &rng)
+{
+    int N = board.getBoardSize();
+    int box = board.getSquareSize();
+    vector<int> digits(N);
+
+    board.clearBoard();
+    for (int sq = 0; sq < box; sq++)
+    {
+        for (int i = 0; i < N; i++)
+            digits[i] = i + 1;
+        shuffle(digits.data(), N, rng);
+        for (int i = 0; i < N; i++)
+            board.setCell(sq * box + i / box, sq * box + i % box, digits[i]);
+    }
+    int recur = 0, backtrack = 0;
+    board.solveSudoku(recur, backtrack);
+    string grid = board.toString();
+
+    vector<int> bands(box), stacks(box), inner(box), rows(N), cols(N);
+    for (int i = 0; i < box; i++)
+        bands[i] = stacks[i] = i;
+    shuffle(bands.data(), box, rng);
+    shuffle(stacks.data(), box, rng);
+    for (int b = 0; b < box; b++)
+    {
+        for (int k = 0; k < box; k++)
+            inner[k] = k;
+        shuffle(inner.data(), box, rng);
+        for (int k = 0; k < box; k++)
+            rows[b * box + k] = bands[b] * box + inner[k];
+        shuffle(inner.data(), box, rng);
+        for (int k = 0; k < box; k++)
+            cols[b * box + k] = stacks[b] * box + inner[k];
+    }
+    bool transpose = pick(rng, 2) == 1;
+
+    string result(N * N, '.');
+    for (int r = 0; r < N; r++)
+    {
+        for (int c = 0; c < N; c++)
+            result[r * N + c] = transpose ? grid[cols[c] * N + rows[r]] : grid[rows[r] * N + cols[c]];
+    }
+    return result;
+}
+
+/**
+ * Counts the solutions with propagation and the most constrained cell first. A puzzle the propagation
+ * finishes at the first node needs no guessing; it is Easy when no locked candidate was used.
+ * @param board The board to search on.
+ * @param puzzle The puzzle text.
+ * @param difficulty Receives the band.
+ * @return The number of solutions, up to 2.
+*/
+long PuzzleGenerator::check(SudokuBoard &board, const string &puzzle, Difficulty &difficulty)
+{
+    int recur = 0, backtrack = 0;
+    board.initializeBoard(puzzle);
+    long solutions = board.countSolutions(2, recur, backtrack);
+    if (recur > 1)
+        difficulty = Hard;
+    else if (board.getPropagationStats().lockedEliminations > 0)
+        difficulty = Medium;
+    else
+        difficulty = Easy;
+    return solutions;
+}
+
+/**
+ * Builds one puzzle. Removing a clue can only add solutions, so a clue that cannot be removed once never
+ * can be later and one pass over the cells in random order is enough.
+ * @param board The board to work on.
+ * @param opts The targets.
+ * @param index The index of the puzzle.
+ * @param result Receives the puzzle.
+*/
+void PuzzleGenerator::generateOne(SudokuBoard &board, const GeneratorOptions &opts, long long index,
+                                  GeneratedPuzzle &result)
+{
+    seed_seq seq{opts.seed, (unsigned int)(index & 0xffffffff), (unsigned int)(index >> 32)};
+    mt19937 rng(seq);
+    board.setSelection(MinRemaining);
+    board.setPropagation(true);
+
+    int cells = board.getBoardSize() * board.getBoardSize();
+    vector<int> order(cells);
+    for (int attempt = 1; attempt <= max(1, opts.maxAttempts); attempt++)
+    {
+        string solution = randomGrid(board, rng);
+        string puzzle = solution;
+        int clues = cells;
+        Difficulty difficulty = Easy; // a full grid needs nothing but singles
+
+        for (int k = 0; k < cells; k++)
+            order[k] = k;
+        shuffle(order.data(), cells, rng);
+
+        for (int k = 0; k < cells && (opts.clues == 0 || clues > opts.clues); k++)
+        {
+            int cell = order[k];
+            int mirror = opts.symmetric ? cells - 1 - cell : cell;
+            // the cell went with its mirror, or the pair would overshoot the clue target
+            int removed = (mirror == cell) ? 1 : 2;
+            if (puzzle[cell] == '.' || (opts.clues > 0 && clues - removed < opts.clues))
+                continue;
+
+            char kept = puzzle[cell];
+            puzzle[cell] = puzzle[mirror] = '.';
+            Difficulty band;
+            // removals can only make a puzzle harder, so only the easier bands limit them
+            bool anyBand = opts.difficulty == AnyDifficulty || opts.difficulty == Hard;
+            if (check(board, puzzle, band) == 1 && (anyBand || band <= opts.difficulty))
+            {
+                clues -= removed;
+                difficulty = band;
+            }
+            else
+            {
+                puzzle[cell] = kept;
+                puzzle[mirror] = solution[mirror];
+            }
+        }
+
+        result.puzzle = puzzle;
+        result.solution = solution;
+        result.clues = clues;
+        result.difficulty = difficulty;
+        result.attempts = attempt;
+        result.matched = (opts.clues == 0 || clues <= opts.clues) &&
+                         (opts.difficulty == AnyDifficulty || difficulty == opts.difficulty);
+        if (result.matched)
+            return;
+    }
+}
+
+/**
+ * Submits one task per range of ClaimChunk puzzles. Each task claims its range from a shared cursor and
+ * builds the puzzles on the worker's board. Results go to a ring of window slots, puzzle i to slot i modulo
+ * window, and the tasks are only submitted as the slots they will fill are reported, so memory stays the
+ * same however many puzzles are asked for. The window is a whole number of ranges and every range starts at
+ * a multiple of ClaimChunk, so a range never wraps around the ring.
+ * @param first The index of the first puzzle.
+ * @param count The number of puzzles.
+ * @param report Called on this thread with each index and puzzle, in order.
+*/
+void PuzzleGenerator::generateAll(long long first, int count, function<void(long long, GeneratedPuzzle &)> report)
+{
+    int window = max(WindowChunks, 4 * pool.size()) * ClaimChunk;
+    vector<GeneratedPuzzle> results(min(window, count));
+    vector<char> done(results.size(), 0);
+    mutex doneLock;
+    condition_variable doneCond;
+    atomic<int> cursor(0);
+
+    auto task = [&]() {
+        int begin = cursor.fetch_add(ClaimChunk);
+        int end = min(begin + ClaimChunk, count);
+        SudokuBoard &board = *boards[pool.workerIndex()];
+        for (int i = begin; i < end; i++)
+        {
+            generateOne(board, options, first + i, results[i % window]);
+
+            lock_guard<mutex> guard(doneLock);
+            done[i % window] = 1;
+            doneCond.notify_all();
+        }
+    };
+
+    int submitted = 0; // puzzles covered by the tasks submitted so far
+    for (int i = 0; i < count; i++)
+    {
+        // keep the ring full: a range is only handed out once every slot it fills has been reported
+        for (; submitted < count && submitted + ClaimChunk <= i + window; submitted += ClaimChunk)
+            pool.submit(task);
+        {
+            unique_lock<mutex> guard(doneLock);
+            doneCond.wait(guard, [&] { return done[i % window] != 0; });
+            done[i % window] = 0;
+        }
+        report(first + i, results[i % window]);
+    }
+    pool.wait();
+}
@@ -0,0 +1,137 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author          :Ajinkya Joshi, Anthony Chamoun
+* Date            :March 15th, 2023
+* File name       :PuzzleGenerator.h
+* Purpose         :Builds random puzzles with a unique solution on a
+*                  thread pool, reproducibly from a seed.
+ **************************************************************************/
+
+#ifndef PUZZLEGENERATOR_H
+#define PUZZLEGENERATOR_H
+#include <vector>
+#include <string>
+#include <random>
+#include <atomic>
+#include <functional>
+#include "SudokuBoard.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+/**
+* How much a puzzle asks of the solver, judged by the propagation of solveSudoku.
+* Easy puzzles fall to naked and hidden singles alone, Medium ones also need locked candidates, Hard ones
+* cannot be finished without guessing. AnyDifficulty accepts every puzzle with a unique solution.
+*/
+enum Difficulty { AnyDifficulty, Easy, Medium, Hard };
+
+/**
+* Settings shared by every puzzle of a run.
+*/
+struct GeneratorOptions
+{
+    int boardSize = 9;
+    int clues = 0; // stop removing at this many clues, 0 = remove as long as the solution stays unique
+    Difficulty difficulty = AnyDifficulty;
+    bool symmetric = false; // remove cells in pairs mirrored through the centre
+    unsigned int seed = 1;
+    int maxAttempts = 100; // grids tried per puzzle before settling for one outside the target
+};
+
+/**
+* One generated puzzle.
+*/
+struct GeneratedPuzzle
+{
+    string puzzle; // in SudokuBoard::toString format
+    string solution;
+    int clues = 0;
+    Difficulty difficulty = AnyDifficulty; // the band the puzzle falls in
+    int attempts = 0; // grids tried
+    bool matched = false; // the puzzle meets the clue and difficulty targets
+};
+
+class PuzzleGenerator
+{
+
+/*
+ * Puzzle i is built from its own generator seeded with (seed, i), so a run gives the same puzzles whatever
+ * the number of threads. Every worker owns a board; tasks claim ranges of puzzle indices from an atomic
+ * cursor and the results are reported strictly in index order, through a ring of a bounded number of slots
+ * whatever the count.
+*/
+private:
+    GeneratorOptions options;
+    ThreadPool pool;
+    vector<SudokuBoard*> boards; // one board per worker
+
+    static const int ClaimChunk = 16; // puzzles a task claims at once
+    static const int WindowChunks = 64; // ClaimChunk ranges held at once, at least 4 per worker
+
+    /**
+    * Fills a blank board with a random complete grid.
+    * @param board The board, cleared and filled in place.
+    * @param rng The generator.
+    * @return The grid in SudokuBoard::toString format.
+    */
+    static string randomGrid(SudokuBoard &board, mt19937 &rng);
+
+    /**
+    * Counts the solutions of a puzzle up to two and finds the band it falls in.
+    * @param board The board to search on; left holding the first solution.
+    * @param puzzle The puzzle text.
+    * @param difficulty Receives the band, meaningful only when the solution is unique.
+    * @return The number of solutions, 0, 1 or 2.
+    */
+    static long check(SudokuBoard &board, const string &puzzle, Difficulty &difficulty);
+
+public:
+
+    /**
+    * Creates the pool and the per-worker boards.
+    * @param threads Number of workers, 0 for one per hardware thread.
+    * @param opts Settings applied to every puzzle.
+    */
+    PuzzleGenerator(int threads, GeneratorOptions opts);
+
+    /**
+    * Frees the per-worker boards.
+    */
+    ~PuzzleGenerator();
+
+    /**
+    * Returns the number of worker threads.
+    * @return The number of workers.
+    */
+    int threadCount();
+
+    /**
+    * Builds puzzles first .. first + count - 1 and reports them in index order. report is called on the
+    * calling thread as soon as the next puzzle in order is ready, while later ones are still being built.
+    * @param first The index of the first puzzle.
+    * @param count The number of puzzles.
+    * @param report Called once per puzzle with its index and the puzzle.
+    */
+    void generateAll(long long first, int count, function<void(long long, GeneratedPuzzle &)> report);
+
+    /**
+    * Builds one puzzle: a random grid from which clues are removed in random order, each removal kept only
+    * while the solution stays unique and the puzzle stays within the difficulty target. Grids that end
+    * above the clue target or below the difficulty target are replaced, up to maxAttempts.
+    * @param board The board to work on; its settings are overwritten.
+    * @param opts The targets.
+    * @param index The index of the puzzle, which seeds it together with opts.seed.
+    * @param result Receives the puzzle.
+    */
+    static void generateOne(SudokuBoard &board, const GeneratorOptions &opts, long long index, GeneratedPuzzle &result);
+
+    /**
+    * Returns the name of a difficulty band.
+    * @param difficulty The band.
+    * @return "any", "easy", "medium" or "hard".
+    */
+    static const char* difficultyName(Difficulty difficulty);
+};
+
+#endif
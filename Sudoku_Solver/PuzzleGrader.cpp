@@ -0,0 +1,683 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author : Ajinkya Joshi, Anthony Chamoun
+* Date : March 15, 2023
+* File name : PuzzleGrader.cpp - Difficulty by solving technique
+* Purpose : Solves with human techniques, easiest first, and rates the
+*           puzzle by the hardest one it needed
+****************************************************************************/
+
+#include "PuzzleGrader.h"
+
+using namespace std;
+
+/**
+ * Moves to the next k-element combination of 0..n-1, in increasing order.
+ * @param pick the combination, sorted; initially 0, 1, ..., k-1
+ * @param k the size of the combination
+ * @param n the number of elements
+ * @return false once every combination has been visited
+*/
+static bool nextCombination(int* pick, int k, int n)
+{
+    int i = k - 1;
+    while (i >= 0 && pick[i] == n - k + i)
+        i--;
+    if (i < 0)
+        return false;
+    pick[i]++;
+    for (int j = i + 1; j < k; j++)
+        pick[j] = pick[j - 1] + 1;
+    return true;
+}
+
+
+/**************************************************************************
+ * Constructor
+****************************************************************************/
+
+
+/**
+ * Picks the unit and peer tables of the board size.
+ * @param N: The size of the boards graded
+*/
+PuzzleGrader::PuzzleGrader(int N) : boardSize(N), board(NULL), grade(NULL)
+{
+    squareSize = 1;
+    while (squareSize * squareSize < N)
+        squareSize++;
+    tables = unitTables(squareSize);
+}
+
+
+/**************************************************************************
+ * Board
+****************************************************************************/
+
+/**
+ * Returns the cells of a unit.
+ * @param u The unit: rows, then columns, then squares.
+ * @return The boardSize cells of the unit.
+*/
+const uint16_t* PuzzleGrader::unit(int u)
+{
+    return tables->units + u * boardSize;
+}
+
+/**
+ * Returns the cells sharing a unit with a cell.
+ * @param cell The cell.
+ * @return The peers, in increasing order.
+*/
+const uint16_t* PuzzleGrader::peersOf(int cell)
+{
+    return tables->peers + cell * tables->peerCount;
+}
+
+/**
+ * Records one use of a technique.
+ * @param technique The technique.
+*/
+void PuzzleGrader::use(Technique technique)
+{
+    grade->uses[technique]++;
+    grade->score += techniqueWeight(technique);
+    if (technique > grade->hardest)
+        grade->hardest = technique;
+}
+
+/**
+ * Tells whether two different cells share a row, a column or a square.
+ * @param a The first cell.
+ * @param b The second cell.
+ * @return True if they are peers.
+*/
+bool PuzzleGrader::sees(int a, int b)
+{
+    return a != b && (tables->rowOf[a] == tables->rowOf[b] || tables->colOf[a] == tables->colOf[b] ||
+                      tables->sqOf[a] == tables->sqOf[b]);
+}
+
+/**
+ * Fills a cell on the board and removes the digit from its peers.
+ * @param cell The cell.
+ * @param digit The digit.
+*/
+void PuzzleGrader::place(int cell, int digit)
+{
+    board->setCell(tables->rowOf[cell], tables->colOf[cell], digit);
+    value[cell] = digit;
+    cand[cell] = 0;
+    DigitMask bit = 1ULL << (digit - 1);
+    const uint16_t* around = peersOf(cell);
+    for (int i = 0; i < tables->peerCount; i++)
+        cand[around[i]] &= ~bit;
+}
+
+/**
+ * Removes digits from the candidates of a cell.
+ * @param cell The cell.
+ * @param digits The digits.
+ * @return True if one of them was a candidate.
+*/
+bool PuzzleGrader::eliminate(int cell, DigitMask digits)
+{
+    if ((cand[cell] & digits) == 0)
+        return false;
+    cand[cell] &= ~digits;
+    return true;
+}
+
+/**
+ * Looks for a blank cell without candidates or a missing digit without a place in its unit.
+ * @return True if the board cannot be finished.
+*/
+bool PuzzleGrader::contradiction()
+{
+    DigitMask full = (1ULL << boardSize) - 1;
+    for (int u = 0; u < 3 * boardSize; u++)
+    {
+        DigitMask seen = 0;
+        for (int k = 0; k < boardSize; k++)
+        {
+            int cell = unit(u)[k];
+            if (value[cell] != Blank)
+                seen |= 1ULL << (value[cell] - 1);
+            else if (cand[cell] == 0)
+                return true;
+            else
+                seen |= cand[cell];
+        }
+        if (seen != full)
+            return true;
+    }
+    return false;
+}
+
+
+/**************************************************************************
+ * Techniques
+****************************************************************************/
+
+/**
+ * Places every digit that has one place left in some unit.
+ * @return True if a digit was placed.
+*/
+bool PuzzleGrader::hiddenSingles()
+{
+    bool progress = false;
+    for (int u = 0; u < 3 * boardSize; u++)
+    {
+        // digits that are a candidate of exactly one cell of the unit
+        DigitMask once = 0, twice = 0;
+        for (int k = 0; k < boardSize; k++)
+        {
+            twice |= once & cand[unit(u)[k]];
+            once |= cand[unit(u)[k]];
+        }
+        DigitMask hidden = once & ~twice;
+        for (int k = 0; hidden != 0 && k < boardSize; k++)
+        {
+            int cell = unit(u)[k];
+            DigitMask m = cand[cell] & hidden;
+            if (m == 0)
+                continue;
+            // when two digits have this cell as their only place, the lower one is placed; the other is
+            // then left without a place in the unit, which contradiction() reports at the next round
+            int digit = __builtin_ctzll(m) + 1;
+            hidden &= ~m;
+            place(cell, digit);
+            use(HiddenSingle);
+            progress = true;
+        }
+    }
+    return progress;
+}
+
+/**
+ * Places the only candidate of every cell that has one left.
+ * @return True if a digit was placed.
+*/
+bool PuzzleGrader::nakedSingles()
+{
+    bool progress = false;
+    for (int cell = 0; cell < boardSize * boardSize; cell++)
+    {
+        DigitMask m = cand[cell];
+        if (m != 0 && (m & (m - 1)) == 0)
+        {
+            place(cell, __builtin_ctzll(m) + 1);
+            use(NakedSingle);
+            progress = true;
+        }
+    }
+    return progress;
+}
+
+/**
+ * For every square and digit, checks whether its places lie in one row or column (pointing), and for every
+ * line and digit whether they lie in one square (claiming).
+ * @return True if a candidate was removed.
+*/
+bool PuzzleGrader::lockedCandidates()
+{
+    for (int u = 0; u < 3 * boardSize; u++)
+    {
+        bool square = u >= 2 * boardSize;
+        for (int digit = 1; digit <= boardSize; digit++)
+        {
+            DigitMask bit = 1ULL << (digit - 1);
+            int first = -1;
+            bool sameRow = true, sameCol = true, sameSquare = true;
+            for (int k = 0; k < boardSize; k++)
+            {
+                int cell = unit(u)[k];
+                if (!(cand[cell] & bit))
+                    continue;
+                if (first < 0)
+                {
+                    first = cell;
+                    continue;
+                }
+                sameRow = sameRow && tables->rowOf[cell] == tables->rowOf[first];
+                sameCol = sameCol && tables->colOf[cell] == tables->colOf[first];
+                sameSquare = sameSquare && tables->sqOf[cell] == tables->sqOf[first];
+            }
+            if (first < 0)
+                continue;
+
+            // the other unit the places are confined to
+            int target = -1;
+            if (square && sameRow)
+                target = tables->rowOf[first];
+            else if (square && sameCol)
+                target = boardSize + tables->colOf[first];
+            else if (!square && sameSquare)
+                target = 2 * boardSize + tables->sqOf[first];
+            if (target < 0)
+                continue;
+
+            bool progress = false;
+            for (int k = 0; k < boardSize; k++)
+            {
+                int cell = unit(target)[k];
+                bool inSource = false;
+                for (int j = 0; j < boardSize && !inSource; j++)
+                    inSource = unit(u)[j] == cell;
+                if (!inSource)
+                    progress = eliminate(cell, bit) || progress;
+            }
+            if (progress)
+            {
+                use(LockedCandidates);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Tries every k blank cells of every unit whose candidates fit in k digits.
+ * @param k The size of the subset.
+ * @return True if a candidate was removed.
+*/
+bool PuzzleGrader::nakedSubsets(int k)
+{
+    for (int u = 0; u < 3 * boardSize; u++)
+    {
+        // only cells with 2 to k candidates can be part of the subset
+        vector<int> cells;
+        for (int i = 0; i < boardSize; i++)
+        {
+            int n = __builtin_popcountll(cand[unit(u)[i]]);
+            if (n >= 2 && n <= k)
+                cells.push_back(unit(u)[i]);
+        }
+        if ((int)cells.size() < k)
+            continue;
+
+        int pick[3] = {0, 1, 2};
+        do
+        {
+            DigitMask digits = 0;
+            for (int i = 0; i < k; i++)
+                digits |= cand[cells[pick[i]]];
+            if (__builtin_popcountll(digits) != k)
+                continue;
+
+            bool progress = false;
+            for (int i = 0; i < boardSize; i++)
+            {
+                int cell = unit(u)[i];
+                bool inSubset = false;
+                for (int j = 0; j < k; j++)
+                    inSubset = inSubset || cells[pick[j]] == cell;
+                if (!inSubset)
+                    progress = eliminate(cell, digits) || progress;
+            }
+            if (progress)
+            {
+                use(k == 2 ? NakedPair : NakedTriple);
+                return true;
+            }
+        } while (nextCombination(pick, k, cells.size()));
+    }
+    return false;
+}
+
+/**
+ * Tries every k digits of every unit whose places fit in k cells.
+ * @param k The size of the subset.
+ * @return True if a candidate was removed.
+*/
+bool PuzzleGrader::hiddenSubsets(int k)
+{
+    for (int u = 0; u < 3 * boardSize; u++)
+    {
+        // the places of every digit with 2 to k of them, one bit per position in the unit
+        vector<int> digits;
+        vector<DigitMask> places;
+        for (int digit = 1; digit <= boardSize; digit++)
+        {
+            DigitMask where = 0;
+            for (int i = 0; i < boardSize; i++)
+                if (cand[unit(u)[i]] & (1ULL << (digit - 1)))
+                    where |= 1ULL << i;
+            int n = __builtin_popcountll(where);
+            if (n >= 2 && n <= k)
+            {
+                digits.push_back(digit);
+                places.push_back(where);
+            }
+        }
+        if ((int)digits.size() < k)
+            continue;
+
+        int pick[3] = {0, 1, 2};
+        do
+        {
+            DigitMask where = 0, keep = 0;
+            for (int i = 0; i < k; i++)
+            {
+                where |= places[pick[i]];
+                keep |= 1ULL << (digits[pick[i]] - 1);
+            }
+            if (__builtin_popcountll(where) != k)
+                continue;
+
+            bool progress = false;
+            for (int i = 0; i < boardSize; i++)
+                if (where & (1ULL << i))
+                    progress = eliminate(unit(u)[i], ~keep) || progress;
+            if (progress)
+            {
+                use(k == 2 ? HiddenPair : HiddenTriple);
+                return true;
+            }
+        } while (nextCombination(pick, k, digits.size()));
+    }
+    return false;
+}
+
+/**
+ * Looks for k rows (then k columns) in which a digit's places cover only k columns (rows).
+ * @param k The size of the fish.
+ * @return True if a candidate was removed.
+*/
+bool PuzzleGrader::fish(int k)
+{
+    for (int orientation = 0; orientation < 2; orientation++)
+    {
+        // base units are rows, cover units columns, or the other way round
+        int base = orientation == 0 ? 0 : boardSize;
+        int cover = orientation == 0 ? boardSize : 0;
+        for (int digit = 1; digit <= boardSize; digit++)
+        {
+            DigitMask bit = 1ULL << (digit - 1);
+            vector<int> lines;
+            vector<DigitMask> places;
+            for (int line = 0; line < boardSize; line++)
+            {
+                DigitMask where = 0;
+                for (int i = 0; i < boardSize; i++)
+                    if (cand[unit(base + line)[i]] & bit)
+                        where |= 1ULL << i;
+                int n = __builtin_popcountll(where);
+                if (n >= 2 && n <= k)
+                {
+                    lines.push_back(line);
+                    places.push_back(where);
+                }
+            }
+            if ((int)lines.size() < k)
+                continue;
+
+            int pick[3] = {0, 1, 2};
+            do
+            {
+                DigitMask where = 0, chosen = 0;
+                for (int i = 0; i < k; i++)
+                {
+                    where |= places[pick[i]];
+                    chosen |= 1ULL << lines[pick[i]];
+                }
+                if (__builtin_popcountll(where) != k)
+                    continue;
+
+                // position i of a base line lies in cover line i, and position line of cover line i in base line line
+                bool progress = false;
+                for (int i = 0; i < boardSize; i++)
+                {
+                    if (!(where & (1ULL << i)))
+                        continue;
+                    for (int line = 0; line < boardSize; line++)
+                        if (!(chosen & (1ULL << line)))
+                            progress = eliminate(unit(cover + i)[line], bit) || progress;
+                }
+                if (progress)
+                {
+                    use(k == 2 ? XWing : Swordfish);
+                    return true;
+                }
+            } while (nextCombination(pick, k, lines.size()));
+        }
+    }
+    return false;
+}
+
+/**
+ * Tries every bivalue cell as the pivot of an XY-Wing.
+ * @return True if a candidate was removed.
+*/
+bool PuzzleGrader::xyWing()
+{
+    for (int pivot = 0; pivot < boardSize * boardSize; pivot++)
+    {
+        DigitMask xy = cand[pivot];
+        if (__builtin_popcountll(xy) != 2)
+            continue;
+        const uint16_t* around = peersOf(pivot);
+        for (int i = 0; i < tables->peerCount; i++)
+        {
+            int a = around[i];
+            DigitMask xz = cand[a];
+            // a shares exactly one digit with the pivot
+            if (__builtin_popcountll(xz) != 2 || __builtin_popcountll(xz & xy) != 1)
+                continue;
+            DigitMask z = xz & ~xy;
+            DigitMask yz = (xy & ~xz) | z;
+            for (int j = 0; j < tables->peerCount; j++)
+            {
+                int b = around[j];
+                if (cand[b] != yz)
+                    continue;
+
+                bool progress = false;
+                const uint16_t* aroundA = peersOf(a);
+                for (int p = 0; p < tables->peerCount; p++)
+                {
+                    int cell = aroundA[p];
+                    if (cell != b && cell != pivot && sees(cell, b))
+                        progress = eliminate(cell, z) || progress;
+                }
+                if (progress)
+                {
+                    use(XYWing);
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * Colors the conjugate pairs of every digit and applies the color wrap and color trap rules.
+ * @return True if a candidate was removed.
+*/
+bool PuzzleGrader::simpleColoring()
+{
+    int cells = boardSize * boardSize;
+    vector<int> component(cells), color(cells), queue;
+    vector<vector<int>> links(cells);
+    for (int digit = 1; digit <= boardSize; digit++)
+    {
+        DigitMask bit = 1ULL << (digit - 1);
+        for (int cell = 0; cell < cells; cell++)
+        {
+            links[cell].clear();
+            component[cell] = -1;
+        }
+        // a unit with exactly two places links them: one of the two holds the digit
+        for (int u = 0; u < 3 * boardSize; u++)
+        {
+            int first = -1, second = -1, count = 0;
+            for (int i = 0; i < boardSize && count <= 2; i++)
+            {
+                if (cand[unit(u)[i]] & bit)
+                {
+                    (count == 0 ? first : second) = unit(u)[i];
+                    count++;
+                }
+            }
+            if (count == 2)
+            {
+                links[first].push_back(second);
+                links[second].push_back(first);
+            }
+        }
+
+        int components = 0;
+        for (int start = 0; start < cells; start++)
+        {
+            if (links[start].empty() || component[start] >= 0)
+                continue;
+            // alternate colors along the links, breadth first
+            vector<int> members;
+            queue.assign(1, start);
+            component[start] = components;
+            color[start] = 0;
+            for (int q = 0; q < (int)queue.size(); q++)
+            {
+                int cell = queue[q];
+                members.push_back(cell);
+                for (int i = 0; i < (int)links[cell].size(); i++)
+                {
+                    int next = links[cell][i];
+                    if (component[next] < 0)
+                    {
+                        component[next] = components;
+                        color[next] = 1 - color[cell];
+                        queue.push_back(next);
+                    }
+                }
+            }
+            components++;
+            if (members.size() < 3)
+                continue;
+
+            // color wrap: two cells of one color in a unit cannot both hold the digit, so that color is false
+            for (int i = 0; i < (int)members.size(); i++)
+            {
+                for (int j = i + 1; j < (int)members.size(); j++)
+                {
+                    if (color[members[i]] != color[members[j]] || !sees(members[i], members[j]))
+                        continue;
+                    int wrong = color[members[i]];
+                    for (int m = 0; m < (int)members.size(); m++)
+                        if (color[members[m]] == wrong)
+                            eliminate(members[m], bit);
+                    use(SimpleColoring);
+                    return true;
+                }
+            }
+
+            // color trap: one of the colors holds the digit, so a cell seeing both colors cannot
+            bool progress = false;
+            for (int cell = 0; cell < cells; cell++)
+            {
+                if (!(cand[cell] & bit) || component[cell] == component[start])
+                    continue;
+                bool seesColor[2] = {false, false};
+                for (int m = 0; m < (int)members.size(); m++)
+                    if (sees(cell, members[m]))
+                        seesColor[color[members[m]]] = true;
+                if (seesColor[0] && seesColor[1])
+                    progress = eliminate(cell, bit) || progress;
+            }
+            if (progress)
+            {
+                use(SimpleColoring);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+
+/**************************************************************************
+ * Grading
+****************************************************************************/
+
+/**
+ * Runs the techniques from the easiest up until the board is full, stuck or contradictory.
+ * @param sdk The board holding the puzzle.
+ * @return The grade.
+*/
+PuzzleGrade PuzzleGrader::gradeBoard(SudokuBoard &sdk)
+{
+    PuzzleGrade result;
+    // a clue repeated in a unit leaves the masks without a trace of the repeat, so it is checked on the cells
+    if (!sdk.isConsistent())
+    {
+        result.valid = false;
+        return result;
+    }
+    board = &sdk;
+    grade = &result;
+
+    int cells = boardSize * boardSize;
+    cand.assign(cells, 0);
+    value.assign(cells, Blank);
+    for (int cell = 0; cell < cells; cell++)
+    {
+        value[cell] = sdk.getCell(tables->rowOf[cell], tables->colOf[cell]);
+        if (value[cell] == Blank)
+            cand[cell] = sdk.candidates(tables->rowOf[cell], tables->colOf[cell]);
+    }
+
+    for (;;)
+    {
+        if (contradiction())
+        {
+            result.valid = false;
+            break;
+        }
+        bool blank = false;
+        for (int cell = 0; cell < cells && !blank; cell++)
+            blank = cand[cell] != 0;
+        if (!blank)
+        {
+            result.solved = true;
+            break;
+        }
+
+        // the first technique that makes progress ends the round
+        if (hiddenSingles() || nakedSingles() || lockedCandidates() || nakedSubsets(2) || hiddenSubsets(2) ||
+            nakedSubsets(3) || hiddenSubsets(3) || fish(2) || fish(3) || xyWing() || simpleColoring())
+            continue;
+
+        use(Guessing);
+        break;
+    }
+
+    board = NULL;
+    grade = NULL;
+    return result;
+}
+
+/**
+ * Returns the name of a technique.
+ * @param technique The technique.
+ * @return The name.
+*/
+const char* PuzzleGrader::techniqueName(Technique technique)
+{
+    static const char* names[TechniqueCount] = {"hidden-single", "naked-single", "locked-candidates",
+                                                "naked-pair", "hidden-pair", "naked-triple", "hidden-triple",
+                                                "x-wing", "swordfish", "xy-wing", "simple-coloring", "guessing"};
+    return names[technique];
+}
+
+/**
+ * Returns the score a technique adds each time it is used.
+ * @param technique The technique.
+ * @return The weight.
+*/
+int PuzzleGrader::techniqueWeight(Technique technique)
+{
+    static const int weights[TechniqueCount] = {1, 2, 5, 10, 12, 20, 25, 30, 45, 50, 60, 200};
+    return weights[technique];
+}
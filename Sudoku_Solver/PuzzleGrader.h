@@ -0,0 +1,193 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author          :Ajinkya Joshi, Anthony Chamoun
+* Date            :March 15th, 2023
+* File name       :PuzzleGrader.h
+* Purpose         :Rates a puzzle by the hardest human solving technique
+*                  it needs, instead of by the work of the search.
+ **************************************************************************/
+
+#ifndef PUZZLEGRADER_H
+#define PUZZLEGRADER_H
+#include <string>
+#include <vector>
+#include "SudokuBoard.h"
+#include "BoardTables.h"
+
+using namespace std;
+
+/**
+* Solving techniques, from the easiest to the hardest. Guessing stands for a puzzle none of the others finish.
+*/
+enum Technique { HiddenSingle, NakedSingle, LockedCandidates, NakedPair, HiddenPair, NakedTriple, HiddenTriple,
+                 XWing, Swordfish, XYWing, SimpleColoring, Guessing };
+
+const int TechniqueCount = Guessing + 1;
+
+/**
+* Outcome of grading one puzzle.
+*/
+struct PuzzleGrade
+{
+    bool valid = true; // false when the clues contradict each other
+    bool solved = false; // the techniques alone finished the board
+    Technique hardest = HiddenSingle; // hardest technique used
+    int score = 0; // sum of the weights of every technique use
+    int uses[TechniqueCount] = {}; // times each technique made progress
+};
+
+class PuzzleGrader
+{
+
+/*
+ * The grader works on the board's own cells and row, column and square masks and keeps, next to them, the
+ * digits each technique has ruled out of every cell. Every round tries the techniques from the easiest up and
+ * goes back to the easiest after the first one that makes progress, so a harder technique is only charged
+ * when nothing easier works. A use of a technique is one placed digit for the singles and one pattern that
+ * removed candidates for the others.
+*/
+private:
+    int boardSize;
+    int squareSize;
+    const UnitTables* tables; // rows, columns, squares and peers of every cell, shared by all graders
+    vector<int> value; // digit of every cell, a copy of the board's kept for the hot loops
+    vector<DigitMask> cand; // candidates of every blank cell, 0 once filled
+    SudokuBoard* board; // the board being graded
+    PuzzleGrade* grade; // the grade being built
+
+    /**
+    * Returns the cells of a unit.
+    * @param u The unit: rows, then columns, then squares.
+    * @return The boardSize cells of the unit.
+    */
+    const uint16_t* unit(int u);
+
+    /**
+    * Returns the cells sharing a unit with a cell.
+    * @param cell The cell.
+    * @return The peers, in increasing order.
+    */
+    const uint16_t* peersOf(int cell);
+
+    /**
+    * Records one use of a technique.
+    * @param technique The technique.
+    */
+    void use(Technique technique);
+
+    /**
+    * Tells whether two different cells share a unit.
+    * @param a The first cell.
+    * @param b The second cell.
+    * @return True if they are peers.
+    */
+    bool sees(int a, int b);
+
+    /**
+    * Fills a cell and removes its digit from the candidates of its peers.
+    * @param cell The cell.
+    * @param digit The digit.
+    */
+    void place(int cell, int digit);
+
+    /**
+    * Removes digits from the candidates of a blank cell.
+    * @param cell The cell.
+    * @param digits The digits to remove.
+    * @return True if at least one of them was a candidate.
+    */
+    bool eliminate(int cell, DigitMask digits);
+
+    /**
+    * Tells whether some blank cell has no candidate or some unit has no place left for a missing digit.
+    * @return True if the board cannot be finished.
+    */
+    bool contradiction();
+
+    /**
+    * Hidden singles: a digit with one place left in a unit goes there.
+    * @return True if a digit was placed.
+    */
+    bool hiddenSingles();
+
+    /**
+    * Naked singles: a cell with one candidate left takes it.
+    * @return True if a digit was placed.
+    */
+    bool nakedSingles();
+
+    /**
+    * Pointing and claiming: a digit confined to one line of a square, or to one square of a line, is removed
+    * from the rest of that line or square.
+    * @return True if a candidate was removed.
+    */
+    bool lockedCandidates();
+
+    /**
+    * Naked subsets: k cells of a unit whose candidates together are k digits take those digits.
+    * @param k The size of the subset, 2 or 3.
+    * @return True if a candidate was removed.
+    */
+    bool nakedSubsets(int k);
+
+    /**
+    * Hidden subsets: k digits that fit only k cells of a unit are the only candidates of those cells.
+    * @param k The size of the subset, 2 or 3.
+    * @return True if a candidate was removed.
+    */
+    bool hiddenSubsets(int k);
+
+    /**
+    * Basic fish: when a digit fits only k columns in each of k rows, no other row can have it in those
+    * columns, and the same with rows and columns swapped. X-Wing is k = 2, Swordfish k = 3.
+    * @param k The number of rows (or columns).
+    * @return True if a candidate was removed.
+    */
+    bool fish(int k);
+
+    /**
+    * XY-Wing: a cell with candidates xy, seeing cells with xz and yz; any cell seeing both of those
+    * cannot be z.
+    * @return True if a candidate was removed.
+    */
+    bool xyWing();
+
+    /**
+    * Simple coloring: the cells linked by units where a digit has exactly two places take alternating
+    * colors, one of which holds the digit. A color with two cells in one unit is false; a cell seeing both
+    * colors cannot hold the digit.
+    * @return True if a candidate was removed.
+    */
+    bool simpleColoring();
+
+public:
+
+    /**
+    * Builds the unit and peer tables for a board size.
+    * @param N The size of the boards graded.
+    */
+    PuzzleGrader(int N);
+
+    /**
+    * Grades the puzzle loaded on a board. The board is left with every cell the techniques could fill.
+    * @param sdk The board, of the grader's size.
+    * @return The grade.
+    */
+    PuzzleGrade gradeBoard(SudokuBoard &sdk);
+
+    /**
+    * Returns the name of a technique.
+    * @param technique The technique.
+    * @return The name, e.g. "x-wing".
+    */
+    static const char* techniqueName(Technique technique);
+
+    /**
+    * Returns the score a technique adds each time it is used.
+    * @param technique The technique.
+    * @return The weight, growing with the difficulty.
+    */
+    static int techniqueWeight(Technique technique);
+};
+
+#endif
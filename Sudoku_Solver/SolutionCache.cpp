@@ -0,0 +1,177 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author : Ajinkya Joshi, Anthony Chamoun
+* Date : March 15, 2023
+* File name : SolutionCache.cpp - Solutions of canonical puzzles
+* Purpose : Shared map from canonical forms to their solutions, with an
+*           optional copy on disk between runs
+****************************************************************************/
+
+#include "SolutionCache.h"
+#include "SudokuBoard.h"
+#include <fstream>
+
+using namespace std;
+
+/**************************************************************************
+ * Constructor
+****************************************************************************/
+
+
+/**
+ * Creates an empty cache.
+ * @param maxEntries: The most entries kept
+*/
+SolutionCache::SolutionCache(size_t maxEntries) : capacity(maxEntries), hits(0), misses(0)
+{
+}
+
+
+/**************************************************************************
+ * Lookup
+****************************************************************************/
+
+/**
+ * Looks up a canonical form and counts a hit or a miss.
+ * @param canonical The canonical form of the puzzle.
+ * @param solution Receives the canonical solution.
+ * @return True if the canonical form was cached.
+*/
+bool SolutionCache::lookup(const string &canonical, string &solution)
+{
+    {
+        lock_guard<mutex> guard(lock);
+        unordered_map<string, string>::iterator it = entries.find(canonical);
+        if (it != entries.end())
+        {
+            solution = it->second;
+            hits++;
+            return true;
+        }
+    }
+    misses++;
+    return false;
+}
+
+/**
+ * Remembers the outcome of a canonical puzzle, replacing an entry that turned out wrong. Once the cache is
+ * full, new puzzles are dropped; the ones already in it are as likely to repeat as the new ones.
+ * @param canonical The canonical form of the puzzle.
+ * @param solution The canonical solution, empty if there is none.
+*/
+void SolutionCache::insert(const string &canonical, const string &solution)
+{
+    lock_guard<mutex> guard(lock);
+    unordered_map<string, string>::iterator it = entries.find(canonical);
+    if (it != entries.end())
+        it->second = solution;
+    else if (entries.size() < capacity)
+        entries.emplace(canonical, solution);
+}
+
+/**
+ * Returns the number of entries.
+ * @return The number of cached puzzles.
+*/
+int SolutionCache::size()
+{
+    lock_guard<mutex> guard(lock);
+    return entries.size();
+}
+
+/**
+ * Returns the number of lookups that found their puzzle.
+ * @return The hits so far.
+*/
+long SolutionCache::hitCount()
+{
+    return hits;
+}
+
+/**
+ * Returns the number of lookups that did not find their puzzle.
+ * @return The misses so far.
+*/
+long SolutionCache::missCount()
+{
+    return misses;
+}
+
+
+/**************************************************************************
+ * Files
+****************************************************************************/
+
+/**
+ * Tells whether a line read from a cache file can be an entry: a key of N x N symbols for a supported N, and
+ * a value of "-" or a full board of the same size.
+ * @param key The canonical form.
+ * @param value The solution, "-" for none.
+ * @return True if the entry is well formed.
+*/
+static bool wellFormed(const string &key, const string &value)
+{
+    int N = 0;
+    for (int box = 2; box <= 6; box++)
+        if ((size_t)box * box * box * box == key.size())
+            N = box * box;
+    if (N == 0)
+        return false;
+    for (size_t i = 0; i < key.size(); i++)
+        if (key[i] != '.' && SudokuBoard::symbolToDigit(key[i], N) == Blank)
+            return false;
+    if (value == "-")
+        return true;
+    if (value.size() != key.size())
+        return false;
+    for (size_t i = 0; i < value.size(); i++)
+        if (SudokuBoard::symbolToDigit(value[i], N) == Blank)
+            return false;
+    return true;
+}
+
+/**
+ * Adds the entries of a file written by save, skipping lines that are not well formed, e.g. from a file cut
+ * short or edited by hand.
+ * @param path The file to read.
+ * @return False if the file exists but could not be read.
+*/
+bool SolutionCache::load(const string &path)
+{
+    ifstream in(path);
+    if (!in.is_open())
+        return true;
+
+    string line;
+    while (getline(in, line))
+    {
+        size_t space = line.find(' ');
+        if (space == string::npos || space == 0)
+            continue;
+        string key = line.substr(0, space), solution = line.substr(space + 1);
+        if (!wellFormed(key, solution))
+            continue;
+        if (solution == "-")
+            solution.clear();
+        insert(key, solution);
+    }
+    return !in.bad();
+}
+
+/**
+ * Writes every entry, one per line.
+ * @param path The file to write.
+ * @return False if the file could not be written.
+*/
+bool SolutionCache::save(const string &path)
+{
+    ofstream out(path);
+    if (!out.is_open())
+        return false;
+
+    lock_guard<mutex> guard(lock);
+    for (unordered_map<string, string>::iterator it = entries.begin(); it != entries.end(); ++it)
+        out << it->first << ' ' << (it->second.empty() ? "-" : it->second) << '\n';
+    out.flush();
+    return out.good();
+}
@@ -0,0 +1,91 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author          :Ajinkya Joshi, Anthony Chamoun
+* Date            :March 15th, 2023
+* File name       :SolutionCache.h
+* Purpose         :Remembers the solutions of canonical puzzles so a puzzle
+*                  seen before, up to symmetry, is not searched again.
+ **************************************************************************/
+
+#ifndef SOLUTIONCACHE_H
+#define SOLUTIONCACHE_H
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+
+using namespace std;
+
+class SolutionCache
+{
+
+/*
+ * Keys are canonical forms from SudokuBoard::canonicalForm and values the solutions of those canonical
+ * boards, so one entry serves every puzzle of the same symmetry class; the caller maps the solution back with
+ * fromCanonical. An empty value records a puzzle without a solution. The map is shared by the workers of a
+ * batch and guarded by one lock, held only for the lookup or insertion itself.
+*/
+private:
+    unordered_map<string, string> entries;
+    mutex lock;
+    size_t capacity; // entries kept at most; later puzzles are not remembered
+    atomic<long> hits;
+    atomic<long> misses;
+
+public:
+
+    /**
+    * Creates an empty cache.
+    * @param maxEntries The most entries kept.
+    */
+    SolutionCache(size_t maxEntries = 1000000);
+
+    /**
+    * Looks up a canonical form and counts a hit or a miss.
+    * @param canonical The canonical form of the puzzle.
+    * @param solution Receives the canonical solution, empty for a puzzle without one.
+    * @return True if the canonical form was cached.
+    */
+    bool lookup(const string &canonical, string &solution);
+
+    /**
+    * Remembers the outcome of a canonical puzzle, unless the cache is full; an entry already there is replaced.
+    * @param canonical The canonical form of the puzzle.
+    * @param solution The solution of the canonical form, empty if there is none.
+    */
+    void insert(const string &canonical, const string &solution);
+
+    /**
+    * Returns the number of entries.
+    * @return The number of cached puzzles.
+    */
+    int size();
+
+    /**
+    * Returns the number of lookups that found their puzzle.
+    * @return The hits so far.
+    */
+    long hitCount();
+
+    /**
+    * Returns the number of lookups that did not find their puzzle.
+    * @return The misses so far.
+    */
+    long missCount();
+
+    /**
+    * Adds the entries of a file written by save. A missing file is an empty cache.
+    * @param path The file to read.
+    * @return False if the file exists but could not be read.
+    */
+    bool load(const string &path);
+
+    /**
+    * Writes every entry, one per line: the canonical form, a space and the solution, or "-" for none.
+    * @param path The file to write.
+    * @return False if the file could not be written.
+    */
+    bool save(const string &path);
+};
+
+#endif
@@ -0,0 +1,346 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author : Ajinkya Joshi, Anthony Chamoun
+* Date : March 15, 2023
+* File name : SolverServer.cpp - Long-running solver
+* Purpose : Answers one-line puzzles over a Unix socket or stdin/stdout,
+*           in request order on every connection
+****************************************************************************/
+
+#include "SolverServer.h"
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+/**
+ * One client: its descriptors, the board for requests solved on its own thread and the answers waiting to be
+ * written in order. Answers are only queued by the threads that finish them; the connection's writer thread
+ * is the only one that blocks on the client, so a client that stops reading holds up nobody but itself.
+*/
+struct SolverServer::Connection
+{
+    // queued answer bytes at which the reader stops taking requests until the client catches up
+    static const size_t MaxQueued = 1 << 20;
+
+    int in;
+    int out;
+    bool ownsDescriptors; // a socket is closed with the connection, stdin and stdout are not
+    SudokuBoard board;
+    DancingLinks* dlx; // used instead of solveSudoku with useDlx, NULL otherwise
+    mutex lock; // guards everything below
+    condition_variable idle; // signalled when outstanding drops to zero
+    condition_variable queued; // signalled when the outbox gains text or the connection is closing
+    condition_variable drained; // signalled when the writer takes the outbox
+    long nextRequest = 0; // sequence number of the next request read
+    long nextAnswer = 0; // sequence number of the next answer to queue
+    map<long, string> ready; // answers finished before the ones in front of them
+    string outbox; // answers in order, not yet handed to the writer
+    int outstanding = 0; // requests read and not yet answered
+    bool closing = false; // no more answers will come
+    bool broken = false; // the client went away; answers are dropped
+
+    Connection(int inFd, int outFd, bool owns, int N, const SolverOptions &options)
+        : in(inFd), out(outFd), ownsDescriptors(owns), board(N)
+    {
+        board.setSelection(options.selection);
+        board.setPropagation(options.propagate);
+        dlx = options.useDlx ? new DancingLinks(N) : NULL;
+    }
+
+    ~Connection()
+    {
+        delete dlx;
+        if (ownsDescriptors)
+            close(in);
+    }
+
+    /**
+    * Stores an answer and queues every answer that is now next in order.
+    * @param sequence The number of the request, counted from 0 on this connection.
+    * @param answer The answer line.
+    */
+    void finish(long sequence, const string &answer)
+    {
+        lock_guard<mutex> guard(lock);
+        ready[sequence] = answer;
+        bool added = false;
+        while (!ready.empty() && ready.begin()->first == nextAnswer)
+        {
+            if (!broken)
+                outbox += ready.begin()->second;
+            ready.erase(ready.begin());
+            nextAnswer++;
+            added = true;
+        }
+        if (added)
+            queued.notify_one();
+        outstanding--;
+        if (outstanding == 0)
+            idle.notify_all();
+    }
+
+    /**
+    * Writes queued answers to the client until the connection is closing and the outbox is empty. Runs on a
+    * thread of its own.
+    */
+    void writeAnswers()
+    {
+        string text;
+        for (;;)
+        {
+            {
+                unique_lock<mutex> guard(lock);
+                queued.wait(guard, [&] { return !outbox.empty() || closing; });
+                if (outbox.empty())
+                    return;
+                text.swap(outbox);
+                outbox.clear();
+                drained.notify_all();
+            }
+            size_t done = 0;
+            while (done < text.size())
+            {
+                ssize_t n = ::write(out, text.data() + done, text.size() - done);
+                if (n < 0 && errno == EINTR)
+                    continue;
+                if (n <= 0)
+                {
+                    // a client that went away just stops receiving
+                    lock_guard<mutex> guard(lock);
+                    broken = true;
+                    outbox.clear();
+                    drained.notify_all();
+                    break;
+                }
+                done += n;
+            }
+        }
+    }
+
+    /**
+    * Waits until the queued answers are few enough to take more requests.
+    */
+    void waitForRoom()
+    {
+        unique_lock<mutex> guard(lock);
+        drained.wait(guard, [&] { return outbox.size() < MaxQueued || broken; });
+    }
+};
+
+const size_t SolverServer::Connection::MaxQueued;
+
+/**
+ * Formats the answer to a solved request.
+ * @param result The outcome of the search.
+ * @param received When the request was read.
+ * @return The answer line.
+*/
+static string answerLine(const PuzzleResult &result, chrono::steady_clock::time_point received)
+{
+    double micros = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - received).count() / 1000.0;
+    char tail[64];
+    const char* status = result.gaveUp ? "-" : (result.solved ? "1" : "0");
+    snprintf(tail, sizeof(tail), " %s %d %.1f\n", status, result.recursiveCount - 1, micros);
+    return result.solution + tail;
+}
+
+
+/**************************************************************************
+ * Constructor
+****************************************************************************/
+
+
+/**
+ * Creates a server on top of a batch solver.
+ * @param solver: The solver whose workers take the batched requests
+ * @param N: The size of the boards served
+ * @param opts: Solver settings for requests solved on a connection thread
+*/
+SolverServer::SolverServer(BatchSolver &solver, int N, SolverOptions opts) : batch(solver), boardSize(N), options(opts)
+{
+}
+
+
+/**************************************************************************
+ * Serving
+****************************************************************************/
+
+/**
+ * Answers one request line, on this thread when it came alone and nothing is in flight, so its answer cannot
+ * overtake an earlier one, and on a worker otherwise.
+ * @param connection The connection it came from.
+ * @param line The request.
+ * @param alone True if no other request was read with it.
+*/
+void SolverServer::request(shared_ptr<Connection> connection, const string &line, bool alone)
+{
+    chrono::steady_clock::time_point received = chrono::steady_clock::now();
+    long sequence;
+    bool inFlight;
+    {
+        lock_guard<mutex> guard(connection->lock);
+        sequence = connection->nextRequest++;
+        inFlight = connection->outstanding > 0;
+        connection->outstanding++;
+    }
+
+    // anything after a '#' is a comment, as in the generator's output
+    size_t length = min(line.find('#'), line.size());
+    int cells = 0;
+    for (size_t i = 0; i < length; i++)
+        if (!isspace((unsigned char)line[i]))
+            cells++;
+    if (cells != boardSize * boardSize)
+    {
+        connection->finish(sequence, "error expected " + to_string(boardSize * boardSize) + " cells\n");
+        return;
+    }
+
+    if (alone && !inFlight)
+    {
+        PuzzleResult result;
+        connection->board.initializeBoard(line.data(), length);
+        BatchSolver::solveBoard(connection->board, connection->dlx, result, NULL, 0, options.countLimit,
+                                options.cache, options.budget);
+        connection->finish(sequence, answerLine(result, received));
+        return;
+    }
+    batch.submit(line.substr(0, length), [connection, sequence, received](PuzzleResult &result) {
+        connection->finish(sequence, answerLine(result, received));
+    });
+}
+
+/**
+ * Splits what the client sends into lines and answers each of them, while a second thread writes the
+ * answers. Once the client stops sending, the connection is kept until its last answer has been written.
+ * @param connection The connection.
+*/
+void SolverServer::serve(shared_ptr<Connection> connection)
+{
+    thread writer(&Connection::writeAnswers, connection.get());
+    string pending; // the start of a line whose end has not arrived yet
+    char chunk[65536];
+    for (;;)
+    {
+        // a client that sends without reading is not read from either, which bounds its queued answers
+        connection->waitForRoom();
+        ssize_t n = ::read(connection->in, chunk, sizeof(chunk));
+        if (n <= 0)
+            break;
+        pending.append(chunk, n);
+
+        vector<string> lines;
+        size_t start = 0, end;
+        while ((end = pending.find('\n', start)) != string::npos)
+        {
+            size_t length = end - start;
+            if (length > 0 && pending[end - 1] == '\r')
+                length--;
+            if (length > 0)
+                lines.push_back(pending.substr(start, length));
+            start = end + 1;
+        }
+        pending.erase(0, start);
+
+        for (int i = 0; i < (int)lines.size(); i++)
+            request(connection, lines[i], lines.size() == 1 && pending.empty());
+    }
+    if (!pending.empty())
+        request(connection, pending, true);
+
+    {
+        unique_lock<mutex> guard(connection->lock);
+        connection->idle.wait(guard, [&] { return connection->outstanding == 0; });
+        connection->closing = true;
+        connection->queued.notify_one();
+    }
+    writer.join();
+}
+
+/**
+ * Binds the socket and starts a detached thread for every client.
+ * @param path The socket path.
+ * @return False if the socket could not be set up or accept failed.
+*/
+bool SolverServer::listenOn(const string &path)
+{
+    // a client closing early must not kill the server in the middle of a write
+    signal(SIGPIPE, SIG_IGN);
+
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path))
+    {
+        cerr << "Socket path too long: " << path << endl;
+        return false;
+    }
+    strcpy(address.sun_path, path.c_str());
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+    {
+        cerr << "Cannot create socket" << endl;
+        return false;
+    }
+    // only a socket left by an earlier server is replaced; anything else at the path is not ours to delete
+    struct stat existing;
+    if (lstat(path.c_str(), &existing) == 0)
+    {
+        if (!S_ISSOCK(existing.st_mode))
+        {
+            cerr << "Not a socket, refusing to replace: " << path << endl;
+            close(listener);
+            return false;
+        }
+        unlink(path.c_str());
+    }
+    if (bind(listener, (sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 128) != 0)
+    {
+        cerr << "Cannot listen on " << path << endl;
+        close(listener);
+        return false;
+    }
+
+    for (;;)
+    {
+        int client = accept(listener, NULL, NULL);
+        if (client < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        shared_ptr<Connection> connection = make_shared<Connection>(client, client, true, boardSize, options);
+        thread(&SolverServer::serve, this, connection).detach();
+    }
+    cerr << "Stopped accepting on " << path << endl;
+    close(listener);
+    return false;
+}
+
+/**
+ * Serves one client on the calling thread.
+ * @param in The descriptor requests are read from.
+ * @param out The descriptor answers are written to.
+*/
+void SolverServer::serveStream(int in, int out)
+{
+    signal(SIGPIPE, SIG_IGN);
+    serve(make_shared<Connection>(in, out, false, boardSize, options));
+}
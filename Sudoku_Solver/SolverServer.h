@@ -0,0 +1,80 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author          :Ajinkya Joshi, Anthony Chamoun
+* Date            :March 15th, 2023
+* File name       :SolverServer.h
+* Purpose         :Keeps a solver running and answers puzzles sent over a
+*                  Unix domain socket or a pair of file descriptors.
+ **************************************************************************/
+
+#ifndef SOLVERSERVER_H
+#define SOLVERSERVER_H
+#include <string>
+#include <memory>
+#include "BatchSolver.h"
+
+using namespace std;
+
+class SolverServer
+{
+
+/*
+ * Every request is one line holding a puzzle in the one-line format, optionally followed by a "#" comment;
+ * the answer is one line
+ *     <board> <status> <recursive calls> <latency us>
+ * or "error <reason>" for a line that is not a puzzle of the served size. The status is 1 when solved, 0 when
+ * there is no solution and "-" when the search budget ran out. Answers on a connection come back in the order
+ * of its requests. A request that arrives alone, with nothing else outstanding on its connection, is
+ * solved right away on the connection's thread, which saves handing it to a worker; requests that arrive
+ * together are spread over the workers of the batch solver. The latency runs from the moment the request line
+ * was read to the moment its answer was ready. Answers are written by a thread of the connection, never by a
+ * worker, and a client that leaves its answers unread is not read from either once a megabyte of them waits.
+*/
+private:
+    struct Connection;
+
+    BatchSolver &batch;
+    int boardSize;
+    SolverOptions options;
+
+    /**
+    * Reads requests from a connection until the peer closes it, then waits for its outstanding answers.
+    * @param connection The connection.
+    */
+    void serve(shared_ptr<Connection> connection);
+
+    /**
+    * Answers one request line.
+    * @param connection The connection it came from.
+    * @param line The request.
+    * @param alone True if no other request was read with it, so it may be solved on this thread.
+    */
+    void request(shared_ptr<Connection> connection, const string &line, bool alone);
+
+public:
+
+    /**
+    * Creates a server on top of a batch solver.
+    * @param solver The solver whose workers take the batched requests.
+    * @param N The size of the boards served.
+    * @param opts The solver settings, used for requests solved on a connection thread.
+    */
+    SolverServer(BatchSolver &solver, int N, SolverOptions opts);
+
+    /**
+    * Listens on a Unix domain socket and serves every client on a thread of its own. Does not return unless
+    * the socket cannot be set up or stops accepting.
+    * @param path The socket path; a stale socket there is replaced, any other file makes it fail.
+    * @return False, with the reason on cerr.
+    */
+    bool listenOn(const string &path);
+
+    /**
+    * Serves a single client on a pair of file descriptors, e.g. stdin and stdout, until the input ends.
+    * @param in The descriptor requests are read from.
+    * @param out The descriptor answers are written to.
+    */
+    void serveStream(int in, int out);
+};
+
+#endif
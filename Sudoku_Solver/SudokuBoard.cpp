@@ -4,11 +4,16 @@
 * Date : March 15, 2023
 * File name : SodukoBoard.cpp - Solve Sudoku Puzzles using recursive algorithms
 * Purpose : Reads in a puzzle of more from a files and solves them
-* Usage : g++ SudokuBoard.cpp -o output
+* Usage : g++ *.cpp -o output
 ****************************************************************************/
 
 #include "SudokuBoard.h"
 #include <fstream>
+#include <cctype>
+#include <cstdint>
+#include <algorithm>
+#include "ThreadPool.h"
+#include "OutputWriter.h"
 
 using namespace std;
 
@@ -19,16 +24,108 @@ using namespace std;
 
 /**
  * Initializes a new instance of the SudokuBoard class with the specified board size.
+ * An unsupported size falls back to the standard 9 x 9 board.
  * @param N: The size of the board
 */
 SudokuBoard::SudokuBoard(int N) : boardSize(N)
 {
-    // Resize conflict matricies
-    sdkMatrix.resize(N, N);
-    c_rows.resize(N, N);
-    c_cols.resize(N, N);
-    c_sqs.resize(N, N);
-    clearBoard();
+    if (!supportedSize(N))
+        boardSize = 9;
+    squareSize = 1;
+    while (squareSize * squareSize < boardSize)
+        squareSize++;
+    core = SudokuCore::create(squareSize);
+    tables = unitTables(squareSize);
+}
+
+/**
+ * Creates a board holding a copy of another board's state and settings.
+ * @param other: The board to copy
+*/
+SudokuBoard::SudokuBoard(const SudokuBoard& other)
+    : boardSize(other.boardSize), count(other.count), squareSize(other.squareSize), core(other.core->clone()),
+      tables(other.tables)
+{
+}
+
+/**
+ * Replaces this board's state and settings with a copy of another board's.
+ * @param other: The board to copy
+ * @return This board
+*/
+SudokuBoard& SudokuBoard::operator=(const SudokuBoard& other)
+{
+    if (this != &other)
+    {
+        SudokuCore* copy = other.core->clone();
+        delete core;
+        core = copy;
+        boardSize = other.boardSize;
+        count = other.count;
+        squareSize = other.squareSize;
+        tables = other.tables;
+        // the search context may be of another size
+        delete scratch;
+        scratch = NULL;
+        scratchSolved = false;
+        deadEnd.clear();
+    }
+    return *this;
+}
+
+/**
+ * Frees the board state.
+*/
+SudokuBoard::~SudokuBoard()
+{
+    delete core;
+    delete scratch;
+}
+
+/**
+ * Tells whether a board size has a specialized core.
+ * @param N: The size of the board
+ * @return true if N is 4, 9, 16, 25 or 36
+*/
+bool SudokuBoard::supportedSize(int N)
+{
+    return N == 4 || N == 9 || N == 16 || N == 25 || N == 36;
+}
+
+/**
+ * Converts a puzzle character to a digit of an N x N board.
+ * @param ch: The character
+ * @param N: The size of the board
+ * @return The digit, or Blank
+*/
+int SudokuBoard::symbolToDigit(char ch, int N)
+{
+    int digit = Blank;
+    if (ch >= '1' && ch <= '9')
+        digit = ch - '0';
+    else if (ch >= 'A' && ch <= 'Z')
+        digit = ch - 'A' + 10;
+    else if (ch >= 'a' && ch <= 'z')
+        digit = ch - 'a' + 10;
+    else if (ch == '0' && N == 36)
+        digit = 36;
+    return (digit <= N) ? digit : Blank;
+}
+
+/**
+ * Converts a digit to its puzzle character.
+ * @param digit: The digit, or Blank
+ * @return The character
+*/
+char SudokuBoard::digitToSymbol(int digit)
+{
+    if (digit == Blank)
+        return '.';
+    if (digit <= 9)
+        return '0' + digit;
+    if (digit == 36)
+        return '0';
+    return 'A' + digit - 10;
 }
 
 
@@ -46,13 +143,7 @@ void SudokuBoard::clearBoard()
 {
     // clears conflict matricies
     count = 0;
-    for (int row = 0; row < boardSize; row++)
-        for (int col = 0; col < boardSize; col++) {
-            sdkMatrix[row][col] = Blank;
-            c_rows[row][col] = Blank;
-            c_cols[row][col] = Blank;
-            c_sqs[row][col] = Blank;
-        }
+    core->clear();
 }
 
 
@@ -62,23 +153,82 @@ void SudokuBoard::clearBoard()
 */
 void SudokuBoard::initializeBoard(ifstream& fin)
 {
-    int digit;
     char ch; // holds each value read from file
     clearBoard(); // clear the board first
-    for (int i = 0; i < boardSize; i++)
+    for (int cell = 0; cell < boardSize * boardSize; cell++)
     {
-        for (int j = 0; j < boardSize; j++)
-        {
-            fin >> ch;
-            // If the read char is not Blank
-            if (ch != '.') {
-                digit = ch - '0';// Convert char to int
-                sdkMatrix[i][j] = digit;
-            }
-        }
+        fin >> ch;
+        // If the read char is not Blank
+        int digit = symbolToDigit(ch, boardSize);
+        if (digit != Blank)
+            core->setCell(cell, digit);
     }
 }
 
+/**
+ * Initializes the Sudoku board from puzzle text, one character per cell in row-major order.
+ * @param cells the puzzle text; whitespace is skipped and '.' marks a blank
+*/
+void SudokuBoard::initializeBoard(const string& cells)
+{
+    initializeBoard(cells.data(), cells.size());
+}
+
+/**
+ * Initializes the Sudoku board from puzzle text held in memory, e.g. inside a mapped file.
+ * @param text the first character of the puzzle
+ * @param length the number of characters available; reading stops once every cell is filled
+*/
+void SudokuBoard::initializeBoard(const char* text, size_t length)
+{
+    clearBoard();
+    int cell = 0;
+    for (size_t i = 0; i < length && cell < boardSize * boardSize; i++)
+    {
+        char ch = text[i];
+        if (isspace((unsigned char)ch))
+            continue;
+        int digit = symbolToDigit(ch, boardSize);
+        if (digit != Blank)
+            core->setCell(cell, digit);
+        cell++;
+    }
+}
+
+/**
+ * Initializes the Sudoku board from digits that need no parsing, e.g. unpacked from a binary file.
+ * @param digits one digit per cell, 0 for a blank
+*/
+void SudokuBoard::initializeDigits(const uint8_t* digits)
+{
+    clearBoard();
+    for (int cell = 0; cell < boardSize * boardSize; cell++)
+        if (digits[cell] != Blank && digits[cell] <= boardSize)
+            core->setCell(cell, digits[cell]);
+}
+
+/**
+ * Writes the board as one character per cell in row-major order.
+ * @return the board text with '.' for blank cells
+*/
+string SudokuBoard::toString()
+{
+    string cells;
+    toString(cells);
+    return cells;
+}
+
+/**
+ * Writes the board as one character per cell into a string, keeping the string's storage.
+ * @param cells receives the board text with '.' for blank cells
+*/
+void SudokuBoard::toString(string &cells)
+{
+    cells.resize(boardSize * boardSize);
+    for (int cell = 0; cell < boardSize * boardSize; cell++)
+        cells[cell] = digitToSymbol(core->getCell(cell));
+}
+
 
 /**************************************************************************
  * Methods involved in the algorithm
@@ -92,21 +242,11 @@ void SudokuBoard::initializeBoard(ifstream& fin)
 */
 bool SudokuBoard::findEmpty(int &row, int &col)
 {
-    // If the value of the cell at the specified position is Blank, return true
-    if (sdkMatrix[row][col] == Blank)
-    {
-        return true;
-    }
-
-        // If the value of the cell at the specified position is not Blank, return false
-    else
-    {
-        return false;
-    }
+    return getCell(row, col) == Blank;
 }
 
 /**
- * Checks for conflicts of a number in a given row, column, and 3x3 box square of the Sudoku board.
+ * Checks for conflicts of a number in a given row, column, and square of the Sudoku board.
  * @param number The number to check for conflicts.
  * @param row The row to check for conflicts.
  * @param col The column to check for conflicts.
@@ -114,44 +254,88 @@ bool SudokuBoard::findEmpty(int &row, int &col)
 */
 bool SudokuBoard::checkConflicts(int &number, int &row, int &col)
 {
+    // the cell's own digit is in all three masks and must not count as a conflict, so only its peers can tell
+    if (number == getCell(row, col))
+        return findConflict(row, col, number) < 0;
 
-    // checking for the row by iterating through each column in the row
-    for(int colitr = 0; colitr < boardSize; colitr++)
-    {
-        if ((sdkMatrix[row][colitr] == number) && (colitr != col))
-        {
-            return false;
-        }
-    }
+    DigitMask used = core->rowMask(row) | core->colMask(col) | core->squareMask(squareIndex(row, col));
+    return (used & (1ULL << (number - 1))) == 0;
+}
 
-    // checking for the column by iterating through each row in the column
-    for(int rowitr = 0; rowitr < boardSize; rowitr++)
-    {
-        if ((sdkMatrix[rowitr][col] == number) && (rowitr != row))
-        {
-            return false;
-        }
-    }
+/**
+ * Returns the size of the board.
+ * @return The number of rows (and columns) of the board.
+*/
+int SudokuBoard::getBoardSize()
+{
+    return boardSize;
+}
 
-    // Checking each 3x3 square to find the box square integer division has been utilized.
-    int box_y = row / 3; // y value is the row
-    int box_x = col / 3; // x value is the col
-    for(int colitr = (box_x*3); colitr < (box_x*3)+3; colitr++ )
-        for(int rowitr = (box_y*3); rowitr < (box_y*3)+3; rowitr++ )
-        {
-            if ((sdkMatrix[rowitr][colitr] == number) && (colitr != col) && (rowitr != row))
-            {
-                return false;
-            }
-        }
+/**
+ * Returns the size of the squares of the board.
+ * @return The number of rows (and columns) of each square.
+*/
+int SudokuBoard::getSquareSize()
+{
+    return squareSize;
+}
 
-    // if all for loops are satisfied - no conflict exists.
-    return true;
+/**
+ * Returns the digit stored in a cell.
+ * @param row The row of the cell.
+ * @param col The column of the cell.
+ * @return The digit, or Blank if the cell is empty.
+*/
+int SudokuBoard::getCell(int row, int col)
+{
+    return core->getCell(row * boardSize + col);
+}
+
+/**
+ * Writes a digit into a cell, replacing whatever was there, and updates the bitmasks and blank list.
+ * @param row The row of the cell.
+ * @param col The column of the cell.
+ * @param number The digit to write, or Blank to empty the cell.
+*/
+void SudokuBoard::setCell(int row, int col, int number)
+{
+    core->setCell(row * boardSize + col, number);
+}
+
+/**
+ * Computes the candidate digits of a cell as the complement of its row, column and square bitmasks.
+ * @param row The row of the cell.
+ * @param col The column of the cell.
+ * @return Bitmask of the legal digits, bit k-1 standing for digit k.
+*/
+DigitMask SudokuBoard::candidates(int row, int col)
+{
+    return core->candidates(row * boardSize + col);
+}
+
+/**
+ * Finds the square containing a cell. Squares are numbered row-major starting from the top left.
+ * @param row The row of the cell.
+ * @param col The column of the cell.
+ * @return The square index.
+*/
+int SudokuBoard::squareIndex(int row, int col)
+{
+    return tables->sqOf[row * boardSize + col];
+}
+
+/**
+ * Sets the branching heuristic used by solveSudoku.
+ * @param order The cell selection order.
+*/
+void SudokuBoard::setSelection(SelectionOrder order)
+{
+    core->setSelection(order);
 }
 
 /**
  * Finds the row index of the first empty cell in the Sudoku board.
- * @return The index of the first empty row, or 10 if the board is full.
+ * @return The index of the first empty row, or boardSize if the board is full.
 */
 int SudokuBoard::emptyFinderrow()
 {
@@ -164,11 +348,11 @@ int SudokuBoard::emptyFinderrow()
             }
         }
 
-    return 10;
+    return boardSize;
 }
 /**
  * Finds the index of the first empty cell's column by iterating through the Sudoku board matrix row by row.
- * @return an integer representing the index of the first empty cell's column, or 10 if not found.
+ * @return an integer representing the index of the first empty cell's column, or boardSize if not found.
  */
 int SudokuBoard::emptyFindercol()
 {
@@ -184,10 +368,45 @@ int SudokuBoard::emptyFindercol()
             }
         }
 
-    // if no empty cell is found, return 10
-    return 10;
+    // if no empty cell is found, return boardSize
+    return boardSize;
+}
+
+/**
+ * Runs constraint propagation on the current board.
+ * @return False if the board was found to be contradictory, true otherwise.
+*/
+bool SudokuBoard::propagate()
+{
+    return core->propagate();
+}
+
+/**
+ * Turns constraint propagation inside solveSudoku on or off.
+ * @param enabled True to propagate at every node.
+*/
+void SudokuBoard::setPropagation(bool enabled)
+{
+    core->setPropagation(enabled);
+}
+
+/**
+ * Returns the deductions made by each propagation rule since the board was loaded.
+ * @return The propagation statistics.
+*/
+PropagationStats SudokuBoard::getPropagationStats()
+{
+    return core->getPropagationStats();
 }
 
+/**
+ * Returns where the searches since the board was loaded spent their time.
+ * @return The search profile, all zeros unless built with SUDOKU_PROFILE.
+*/
+SearchProfile SudokuBoard::getSearchProfile()
+{
+    return core->getSearchProfile();
+}
 
 /**
  * Recursive function to solve a Sudoku puzzle
@@ -197,380 +416,706 @@ int SudokuBoard::emptyFindercol()
 */
 bool SudokuBoard::solveSudoku(int& recur, int& backtrack)
 {
-    recur += 1; // increase the recursive call count
+    return core->solve(recur, backtrack);
+}
 
-    // if there are no empty cells left, the puzzle is solved
-    if(emptyFindercol() == 10 || emptyFinderrow() == 10)
+/**
+ * Counts the solutions of the puzzle with the same search as solveSudoku, stopping at a limit
+ * @param limit the number of solutions after which the search stops, 2 to check for a unique solution
+ * @param recur an integer reference to keep track of the number of recursive calls
+ * @param backtrack an integer reference to keep track of the number of times the function backtracks
+ * @return the number of solutions found, at most limit; the board holds the first one
+*/
+long SudokuBoard::countSolutions(long limit, int& recur, int& backtrack)
+{
+    return core->countSolutions(limit, recur, backtrack);
+}
+
+/**
+ * Starts a search to be run in slices by continueSearch
+ * @param limit the number of solutions after which the search stops
+*/
+void SudokuBoard::beginSearch(long limit)
+{
+    core->startSearch(limit);
+}
+
+/**
+ * Runs the started search for at most a number of nodes, continuing where the last slice stopped
+ * @param nodes the node budget of the slice, 0 for none
+ * @param recur an integer reference to keep track of the number of recursive calls
+ * @param backtrack an integer reference to keep track of the number of times the function backtracks
+ * @return true once the search is over, false if the budget ran out first
+*/
+bool SudokuBoard::continueSearch(long nodes, int& recur, int& backtrack)
+{
+    return core->resumeSearch(nodes, recur, backtrack);
+}
+
+/**
+ * Returns the number of solutions found so far by the started search
+ * @return the number of solutions
+*/
+long SudokuBoard::solutionsFound()
+{
+    return core->solutionCount();
+}
+
+/**
+ * Solves the board on a thread pool. The top splitDepth levels are expanded here, then each remaining
+ * subtree is solved on its own copy of the board. All copies share one cancel flag that the first
+ * successful task raises, making the other tasks unwind at their next node.
+ * @param pool the thread pool
+ * @param splitDepth the number of levels to expand before splitting
+ * @param recur an integer reference to keep track of the recursive calls of every thread
+ * @param backtrack an integer reference to keep track of the backtracks of every thread
+ * @return a boolean value indicating if the Sudoku puzzle has been successfully solved
+*/
+bool SudokuBoard::solveParallel(ThreadPool &pool, int splitDepth, int &recur, int &backtrack)
+{
+    vector<SudokuCore*> leaves;
+    if (core->splitSearch(splitDepth, leaves, recur, backtrack))
     {
         return true;
     }
-    else
+
+    atomic<bool> found(false);
+    atomic<int> remaining(leaves.size());
+    atomic<int> taskRecur(0), taskBacktrack(0);
+    SudokuCore* winner = NULL;
+
+    for (int i = 0; i < (int)leaves.size(); i++)
     {
-        int row = emptyFinderrow();
-        int col = emptyFindercol();
-        // iterate through possible values for the cell
-        for(int number = 1; number < boardSize + 1; number++)
+        pool.submit([&, i]() {
+            SudokuCore* leaf = leaves[i];
+            int r = 0, b = 0;
+            leaf->setCancel(&found);
+            // a subtree that fails counts as a backtrack, as in solveSudoku
+            if (!leaf->solve(r, b))
+                b++;
+            else if (!found.exchange(true))
+                winner = leaf;
+            taskRecur += r;
+            taskBacktrack += b;
+            remaining--;
+        });
+    }
+    pool.runUntil([&]() { return remaining == 0; });
+
+    recur += taskRecur;
+    backtrack += taskBacktrack;
+
+    // copy the winning subtree's board back
+    if (winner != NULL)
+        for (int cell = 0; cell < boardSize * boardSize; cell++)
+            core->setCell(cell, winner->getCell(cell));
+    for (int i = 0; i < (int)leaves.size(); i++)
+        delete leaves[i];
+    return winner != NULL;
+}
+
+/**************************************************************************
+ * Symmetry
+****************************************************************************/
+
+// most row orders times column orders canonicalForm compares in one orientation before giving up
+static const long MaxCanonicalOrders = 4096;
+
+/**
+ * Folds a value into a hash.
+ * @param h the hash so far
+ * @param v the value
+ * @return the new hash
+*/
+static uint64_t mixHash(uint64_t h, uint64_t v)
+{
+    return h ^ (v + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+}
+
+/**
+ * Hashes a multiset, so the result does not depend on the order of the values.
+ * @param values the values; sorted in place
+ * @param count the number of values
+ * @return the hash
+*/
+static uint64_t multisetHash(uint64_t* values, int count)
+{
+    sort(values, values + count);
+    uint64_t h = count;
+    for (int i = 0; i < count; i++)
+        h = mixHash(h, values[i]);
+    return h;
+}
+
+/**
+ * Lists the arrangements of items sorted by key in which only items with equal keys trade places.
+ * @param items the items, sorted by key
+ * @param keys the key of every item, indexed by item
+ * @param limit the most arrangements wanted
+ * @param arrangements receives the arrangements
+ * @return false if there are more than limit
+*/
+static bool tiedArrangements(const vector<int> &items, const vector<uint64_t> &keys, long limit,
+                             vector<vector<int>> &arrangements)
+{
+    arrangements.assign(1, vector<int>());
+    int start = 0;
+    while (start < (int)items.size())
+    {
+        int end = start + 1;
+        while (end < (int)items.size() && keys[items[end]] == keys[items[start]])
+            end++;
+        // an item without ties has one place, as in most rows of a real puzzle
+        if (end == start + 1)
+        {
+            for (int i = 0; i < (int)arrangements.size(); i++)
+                arrangements[i].push_back(items[start]);
+            start = end;
+            continue;
+        }
+        vector<int> run(items.begin() + start, items.begin() + end);
+        sort(run.begin(), run.end());
+
+        vector<vector<int>> longer;
+        do
         {
-            // check if the value conflicts with any values in the row, column, or 3x3 box
-            if (checkConflicts(number,row,col))
+            for (int i = 0; i < (int)arrangements.size(); i++)
             {
-                // if there are no conflicts, assign the value to the cell and recursively call the function
-                sdkMatrix[row][col] = number;
+                if ((long)longer.size() >= limit)
+                    return false;
+                longer.push_back(arrangements[i]);
+                longer.back().insert(longer.back().end(), run.begin(), run.end());
+            }
+        } while (next_permutation(run.begin(), run.end()));
+        arrangements.swap(longer);
+        start = end;
+    }
+    return true;
+}
+
+/**
+ * Lists the orders of the rows (or columns) of a board that keep every band (or stack) together, with the
+ * bands sorted by the signatures of their lines and the lines of each band sorted by signature. Only
+ * lines and bands with equal signatures are tried in more than one order.
+ * @param signature the signature of every line
+ * @param box the number of lines in a band
+ * @param limit the most orders wanted
+ * @param orders receives the orders, each giving the source line of every line
+ * @return false if there are more than limit
+*/
+static bool lineOrders(const vector<uint64_t> &signature, int box, long limit, vector<vector<int>> &orders)
+{
+    int N = box * box;
+    vector<uint64_t> bandSignature(box);
+    vector<int> bands(box), sorted(N); // sorted holds the lines of every band, sorted by signature
+    bool tied = false;
+    for (int b = 0; b < box; b++)
+    {
+        uint64_t values[6];
+        copy(signature.begin() + b * box, signature.begin() + (b + 1) * box, values);
+        bandSignature[b] = multisetHash(values, box);
+        bands[b] = b;
+
+        for (int k = 0; k < box; k++)
+            sorted[b * box + k] = b * box + k;
+        sort(sorted.begin() + b * box, sorted.begin() + (b + 1) * box,
+             [&](int x, int y) { return signature[x] < signature[y]; });
+        for (int k = 1; k < box; k++)
+            tied = tied || signature[sorted[b * box + k]] == signature[sorted[b * box + k - 1]];
+    }
+    sort(bands.begin(), bands.end(), [&](int x, int y) { return bandSignature[x] < bandSignature[y]; });
+    for (int b = 1; b < box; b++)
+        tied = tied || bandSignature[bands[b]] == bandSignature[bands[b - 1]];
+
+    // without ties, as in most puzzles, there is one order
+    if (!tied)
+    {
+        orders.assign(1, vector<int>());
+        for (int pos = 0; pos < box; pos++)
+            orders[0].insert(orders[0].end(), sorted.begin() + bands[pos] * box, sorted.begin() + (bands[pos] + 1) * box);
+        return true;
+    }
+
+    vector<vector<vector<int>>> inBand(box); // the orders of the lines of each band
+    long count = 1;
+    for (int b = 0; b < box; b++)
+    {
+        vector<int> lines(sorted.begin() + b * box, sorted.begin() + (b + 1) * box);
+        if (!tiedArrangements(lines, signature, limit, inBand[b]))
+            return false;
+        count *= inBand[b].size();
+        if (count > limit)
+            return false;
+    }
+    vector<vector<int>> bandOrders;
+    if (!tiedArrangements(bands, bandSignature, limit, bandOrders) || count * (long)bandOrders.size() > limit)
+        return false;
 
-                bool solution = solveSudoku(recur, backtrack);
-                if (solution == false)
+    orders.clear();
+    for (int i = 0; i < (int)bandOrders.size(); i++)
+    {
+        // every combination of the orders inside the bands, taken in this band order
+        vector<vector<int>> partial(1);
+        for (int pos = 0; pos < box; pos++)
+        {
+            const vector<vector<int>> &choices = inBand[bandOrders[i][pos]];
+            vector<vector<int>> longer;
+            for (int p = 0; p < (int)partial.size(); p++)
+            {
+                for (int k = 0; k < (int)choices.size(); k++)
                 {
-                    backtrack++;
+                    longer.push_back(partial[p]);
+                    longer.back().insert(longer.back().end(), choices[k].begin(), choices[k].end());
                 }
-                if (solution == true)
+            }
+            partial.swap(longer);
+        }
+        orders.insert(orders.end(), partial.begin(), partial.end());
+    }
+    return true;
+}
+
+/**
+ * Finds the canonical form in two steps. First every row and column gets a signature built from counts no
+ * symmetry changes (how often each digit is used, how many clues share its column, row and square), and
+ * the lines and bands are sorted by signature. Then every order that only swaps lines or bands with equal
+ * signatures is tried, in both orientations, with digits renamed in order of first appearance, and the
+ * smallest text wins. The tried orders of two boards that are the same up to symmetry are the same set, so
+ * they end on the same text.
+ * @param symmetry Receives the symmetry taking the board to the canonical form.
+ * @return The canonical form, or an empty string if too many orders tie.
+*/
+string SudokuBoard::canonicalForm(BoardSymmetry &symmetry)
+{
+    int N = boardSize, box = squareSize, cells = N * N;
+    vector<int> best; // the best text so far, as digit names
+    vector<int> grid(cells), name(N + 1), text(cells);
+
+    for (int t = 0; t < 2; t++)
+    {
+        for (int r = 0; r < N; r++)
+            for (int c = 0; c < N; c++)
+                grid[r * N + c] = t ? core->getCell(c * N + r) : core->getCell(r * N + c);
+
+        vector<int> uses(N + 1, 0), rowClues(N, 0), colClues(N, 0), sqClues(N, 0);
+        for (int cell = 0; cell < cells; cell++)
+        {
+            if (grid[cell] == Blank)
+                continue;
+            uses[grid[cell]]++;
+            rowClues[tables->rowOf[cell]]++;
+            colClues[tables->colOf[cell]]++;
+            sqClues[tables->sqOf[cell]]++;
+        }
+
+        vector<uint64_t> rowSignature(N), colSignature(N);
+        for (int line = 0; line < N; line++)
+        {
+            uint64_t rowItems[36], colItems[36], rowPerStack[6] = {0}, colPerBand[6] = {0};
+            int rowCount = 0, colCount = 0;
+            for (int k = 0; k < N; k++)
+            {
+                int d = grid[line * N + k];
+                if (d != Blank)
                 {
-                    return true;
+                    rowItems[rowCount++] = ((uint64_t)uses[d] << 32) | ((uint64_t)colClues[k] << 16) |
+                                           sqClues[tables->sqOf[line * N + k]];
+                    rowPerStack[k / box]++;
+                }
+                d = grid[k * N + line];
+                if (d != Blank)
+                {
+                    colItems[colCount++] = ((uint64_t)uses[d] << 32) | ((uint64_t)rowClues[k] << 16) |
+                                           sqClues[tables->sqOf[k * N + line]];
+                    colPerBand[k / box]++;
                 }
-
-                // if a solution is not found, backtrack by resetting the cell value to Blank
-                sdkMatrix[row][col] = Blank;
             }
+            rowSignature[line] = mixHash(multisetHash(rowItems, rowCount), multisetHash(rowPerStack, box));
+            colSignature[line] = mixHash(multisetHash(colItems, colCount), multisetHash(colPerBand, box));
         }
 
-        // if all possible values have been tried and a solution has not been found, backtrack
-        return false;
-    }
-}
+        vector<vector<int>> rowOrders, colOrders;
+        if (!lineOrders(rowSignature, box, MaxCanonicalOrders, rowOrders) ||
+            !lineOrders(colSignature, box, MaxCanonicalOrders, colOrders) ||
+            (long)rowOrders.size() * (long)colOrders.size() > MaxCanonicalOrders)
+            return "";
 
-/**************************************************************************/
+        for (int i = 0; i < (int)rowOrders.size(); i++)
+        {
+            const vector<int> &rows = rowOrders[i];
+            for (int j = 0; j < (int)colOrders.size(); j++)
+            {
+                const vector<int> &cols = colOrders[j];
+                fill(name.begin(), name.end(), 0);
+                int named = 0;
+                bool smaller = best.empty();
+                bool larger = false;
+                for (int cell = 0; cell < cells && !larger; cell++)
+                {
+                    int d = grid[rows[cell / N] * N + cols[cell % N]];
+                    if (d != Blank && name[d] == 0)
+                        name[d] = ++named;
+                    text[cell] = name[d];
+                    // stop as soon as this order is known to lose
+                    if (!smaller && text[cell] != best[cell])
+                    {
+                        smaller = text[cell] < best[cell];
+                        larger = !smaller;
+                    }
+                }
+                if (!smaller)
+                    continue;
+
+                best = text;
+                symmetry.transpose = t == 1;
+                symmetry.rows = rows;
+                symmetry.cols = cols;
+                symmetry.digits = name;
+            }
+        }
+    }
 
+    // digits the board does not use take the names left over, in order
+    int named = *max_element(symmetry.digits.begin(), symmetry.digits.end());
+    for (int d = 1; d <= N; d++)
+        if (symmetry.digits[d] == 0)
+            symmetry.digits[d] = ++named;
 
+    string canonical(cells, '.');
+    for (int cell = 0; cell < cells; cell++)
+        canonical[cell] = digitToSymbol(best[cell]);
+    return canonical;
+}
 
 /**
- * Prints out the current state of the sudoku board to both the console and a specified output file.
- * @param out - An output file to write the sudoku board to.
- * @return void
+ * Applies a symmetry to a board text.
+ * @param cells the text
+ * @param symmetry the symmetry
+ * @return the transformed text
 */
-void SudokuBoard::printSudoku(ofstream& out)
+string SudokuBoard::toCanonical(const string &cells, const BoardSymmetry &symmetry)
 {
-    // Prints the board to console
-    for (int i = 1; i <= boardSize; i++)
+    int N = boardSize;
+    string result(N * N, '.');
+    for (int r = 0; r < N; r++)
     {
-        if ((i - 1) % SquareSize == 0)
+        for (int c = 0; c < N; c++)
         {
-            for (int j = 1; j <= boardSize + 1; j++)
-                cout << "---";
-            cout << endl;
+            int gr = symmetry.rows[r], gc = symmetry.cols[c];
+            int from = symmetry.transpose ? gc * N + gr : gr * N + gc;
+            result[r * N + c] = digitToSymbol(symmetry.digits[symbolToDigit(cells[from], N)]);
         }
-        for (int j = 1; j < boardSize + 1; j++)
+    }
+    return result;
+}
+
+/**
+ * Undoes a symmetry on a board text.
+ * @param cells the transformed text
+ * @param symmetry the symmetry
+ * @return the text before the symmetry
+*/
+string SudokuBoard::fromCanonical(const string &cells, const BoardSymmetry &symmetry)
+{
+    int N = boardSize;
+    vector<int> original(N + 1);
+    for (int d = 0; d <= N; d++)
+        original[symmetry.digits[d]] = d;
+
+    string result(N * N, '.');
+    for (int r = 0; r < N; r++)
+    {
+        for (int c = 0; c < N; c++)
         {
-            if ((j - 1) % SquareSize == 0)
-                cout << "|";
-            if (sdkMatrix[i - 1][j - 1] != Blank)
-                cout << " " << sdkMatrix[i - 1][j - 1] << " "; // prints out number
-            else
-                cout << " - "; // prints blank indicating no number.
+            int gr = symmetry.rows[r], gc = symmetry.cols[c];
+            int to = symmetry.transpose ? gc * N + gr : gr * N + gc;
+            result[to] = digitToSymbol(original[symbolToDigit(cells[r * N + c], N)]);
         }
-        cout << "|";
-        cout << endl;
     }
-    cout << " -";
-    for (int j = 1; j <= boardSize - 1; j++)
-        cout << "---";
-    cout << "-";
-    cout << endl;
+    return result;
+}
+
+/**************************************************************************/
+
+
 
-    // Prints the board to the output file
+/**
+ * Prints out the current state of the sudoku board. The writer sends it to the console and the output file.
+ * @param out - The writer to print the sudoku board to.
+ * @return void
+*/
+void SudokuBoard::printSudoku(OutputWriter& out)
+{
     for (int i = 1; i <= boardSize; i++)
     {
-        if ((i - 1) % SquareSize == 0)
+        if ((i - 1) % squareSize == 0)
         {
             for (int j = 1; j <= boardSize + 1; j++)
                 out << "---";
-            out << endl;
+            out << '\n';
         }
         for (int j = 1; j < boardSize + 1; j++)
         {
-            if ((j - 1) % SquareSize == 0)
-                out << "|";
-            if (sdkMatrix[i - 1][j - 1] != Blank)
-                out << " " << sdkMatrix[i - 1][j - 1] << " "; // prints out number
+            if ((j - 1) % squareSize == 0)
+                out << '|';
+            if (getCell(i - 1, j - 1) != Blank)
+                out << ' ' << digitToSymbol(getCell(i - 1, j - 1)) << ' '; // prints out number
             else
                 out << " - "; // prints blank indicating no number.
         }
-        out << "|";
-        out << endl;
+        out << "|\n";
     }
     out << " -";
     for (int j = 1; j <= boardSize - 1; j++)
         out << "---";
-    out << "-";
-    out << endl;
+    out << "-\n";
 }
 
 
 /**
  * Sets the conflict arrays for the current SudokuBoard object based on the current state of the board.
  * The conflict arrays are used to keep track of which numbers are already present in each row, column and sub-square.
- * This function iterates over each cell of the board, and for each non-zero cell value, it updates the corresponding
- * conflict arrays.
+ * The bitmasks are rebuilt from scratch, so it is safe to call at any time.
  * @return void
  */
 void SudokuBoard::setConflict() {
-    // does exactly that
-    for (int i = 0; i < boardSize; i++) {
-        for (int j = 0; j < boardSize; j++) {
-            if (sdkMatrix[i][j] != 0) {
-                int k = sdkMatrix[i][j];
-                int a = findLocation(j, i);
-                c_rows[j][k - 1] = 1;
-                c_cols[i][k - 1] = 1;
-                c_sqs[a][k - 1] = 1;
-            }
-        }
-    }
+    core->rebuild();
 }
 
 
 /**
- * This method prints the conflicts on the Sudoku board to both the console and a given output file.
- * It starts by printing square conflicts to the console, followed by row conflicts, and then column conflicts.
- * It then prints the same information to a text file.
- * @param out The output file to write to
+ * This method prints the conflicts on the Sudoku board: square conflicts, followed by row conflicts,
+ * and then column conflicts. The writer sends them to the console and the output file.
+ * @param out The writer to print to
 */
-void SudokuBoard::printConflict(ofstream& out) {
-    cout << "square conflicts" << endl;
+void SudokuBoard::printConflict(OutputWriter& out) {
+    out << "square conflicts\n";
     for (int i = 0; i < boardSize; i++) {
         for (int j = 0; j < boardSize; j++) {
-            cout << c_sqs[i][j];
+            out << (char)('0' + ((core->squareMask(i) >> j) & 1));
         }
-        cout << endl;
+        out << '\n';
     }
-    cout << "row conflicts" << endl;
+    out << "row conflicts\n";
     for (int i = 0; i < boardSize; i++) {
         for (int j = 0; j < boardSize; j++) {
-            cout << c_cols[i][j];
+            out << (char)('0' + ((core->rowMask(i) >> j) & 1));
         }
-        cout << endl;
+        out << '\n';
     }
-    cout << "col conflicts" << endl;
-    for (int i = 0; i < boardSize; i++) {
-        for (int j = 0; j < boardSize; j++) {
-            cout << c_rows[i][j];
-        }
-        cout << endl;
-    }
-
-    // prints same thing to textfile
-    out << "square conflicts" << endl;
+    out << "col conflicts\n";
     for (int i = 0; i < boardSize; i++) {
         for (int j = 0; j < boardSize; j++) {
-            out << c_sqs[i][j];
+            out << (char)('0' + ((core->colMask(i) >> j) & 1));
         }
-        out << endl;
-    }
-    out << "col conflicts" << endl;
-    for (int i = 0; i < boardSize; i++) {
-        for (int j = 0; j < boardSize; j++) {
-            out << c_cols[i][j];
-        }
-        out << endl;
-    }
-    out << "row conflicts" << endl;
-    for (int i = 0; i < boardSize; i++) {
-        for (int j = 0; j < boardSize; j++) {
-            out << c_rows[i][j];
-        }
-        out << endl;
+        out << '\n';
     }
 }
 
 
 /**
- * Given the row and column numbers, returns the location (0-8) of the corresponding 3x3 subgrid.
+ * Given the row and column numbers, returns the location of the corresponding square.
  * @param row: integer representing the row number (0-based index)
  * @param col: integer representing the column number (0-based index)
- * @return integer representing the location of the 3x3 subgrid (0-8)
+ * @return integer representing the location of the square, numbered row-major from 0
  */
 int SudokuBoard::findLocation(int row, int col) {
-    // determine the location based on the row and column numbers
-    if (row + 1 <= boardSize / 3) {
-        if (col + 1 <= boardSize / 3) {
-            return 0;
-        }
-        else if (col + 1 <= 2 * (boardSize / 3)) {
-            return 3;
-        }
-        else if (col + 1 <= boardSize) {
-            return 6;
-        }
-    }
-    if (row + 1 <= 2 * (boardSize / 3)) {
-        if (col + 1 <= boardSize / 3) {
-            return 1;
-        }
-        else if (col + 1 <= 2 * (boardSize / 3)) {
-            return 4;
-        }
-        else if (col + 1 <= boardSize) {
-            return 7;
-        }
-    }
-    if (row + 1 <= boardSize) {
-        if (col + 1 <= boardSize / 3) {
-            return 2;
-        }
-        else if (col + 1 <= 2 * (boardSize / 3)) {
-            return 5;
-        }
-        else if (col + 1 <= boardSize) {
-            return 8;
-        }
-    }
+    return squareIndex(row, col);
 }
 
 
-
 /**************************************************************************
-* Project 1 TEAM 2
-* author          :Ajinkya Joshi, Anthony Chamoun
-* Date            :March 15th, 2023
-* File name       :main.cpp
-* Purpose         :Solve sudoku boards
- **************************************************************************/
-
-#include <fstream>
-#include <iostream>
-#include "SudokuBoard.h"
-#include <algorithm>
-#include <vector>
-#include <numeric>
-
-using namespace std;
+ * Interactive solving
+****************************************************************************/
 
+/**
+ * Places a digit unless a peer already holds it. The core updates the row, column and square masks of the
+ * cell, so the candidates of every cell are current right after the call.
+ * @param row: The row of the cell
+ * @param col: The column of the cell
+ * @param digit: The digit
+ * @return true if the digit was placed
+*/
+bool SudokuBoard::placeDigit(int row, int col, int digit)
+{
+    if (digit < 1 || digit > boardSize || findConflict(row, col, digit) >= 0)
+        return false;
+    core->setCell(row * boardSize + col, digit);
+    return true;
+}
 
-int main() {
-    int recursiveCount; // # of recursive calls
-    int backtracksCount; // # of backtracks involved for each board
-    int boardCount = 0; // # of Boards from file
-    int boardSize = 9;
-    int solved = 0; // # of boards solved
-    int nosolve = 0; // # of boards not solved
+/**
+ * Empties a cell and gives its digit back to the candidates of its peers.
+ * @param row: The row of the cell
+ * @param col: The column of the cell
+*/
+void SudokuBoard::removeDigit(int row, int col)
+{
+    core->setCell(row * boardSize + col, Blank);
+}
 
-    vector<int> recur;
-    vector<int> backtr;
+/**
+ * Walks the peers of the cell looking for the digit.
+ * @param row: The row of the cell
+ * @param col: The column of the cell
+ * @param digit: The digit
+ * @return the index of the first peer holding the digit, or -1
+*/
+int SudokuBoard::findConflict(int row, int col, int digit)
+{
+    const uint16_t* peers = tables->peers + (row * boardSize + col) * tables->peerCount;
+    for (int i = 0; i < tables->peerCount; i++)
+        if (core->getCell(peers[i]) == digit)
+            return peers[i];
+    return -1;
+}
 
-    // Create SudokuBoard object
-    SudokuBoard* sdk = new SudokuBoard(boardSize);
-    // Open the data file and verify it opens successfully
+/**
+ * Looks for a peer holding the digit of every filled cell.
+ * @return true if no unit holds a digit twice
+*/
+bool SudokuBoard::isConsistent()
+{
+    for (int cell = 0; cell < boardSize * boardSize; cell++)
+    {
+        int digit = core->getCell(cell);
+        if (digit != Blank && findConflict(cell / boardSize, cell % boardSize, digit) >= 0)
+            return false;
+    }
+    return true;
+}
 
+/**
+ * Checks every blank cell and every unit of the board.
+ * @return true if the board cannot be finished
+*/
+bool SudokuBoard::hasContradiction()
+{
+    return core->contradiction();
+}
 
-    // opens sudoku input file
-    ifstream fin;
-    fin.open("/Users/ajinkyajoshi/CLionProjects/algo_project_2/Sudoku3Puzzles.txt");
-    if (!fin)
+/**
+ * Compares the filled cells with the solution the last search left in the scratch core.
+ * @return true if the solution still extends the board
+*/
+bool SudokuBoard::solutionFits()
+{
+    if (scratch == NULL || !scratchSolved)
+        return false;
+    for (int cell = 0; cell < boardSize * boardSize; cell++)
     {
-        cerr << "Cannot open 'sudoku1.txt'" << endl;
-        exit(1);
+        int digit = core->getCell(cell);
+        if (digit != Blank && digit != scratch->getCell(cell))
+            return false;
     }
+    return true;
+}
 
-    // opens and creates output file
-    ofstream out;
-    out.open("/Users/ajinkyajoshi/CLionProjects/algo_project_2/Output.txt");
-    if (!out) {
-        cerr << "Cannot open file << endl";
-        exit(1);
+/**
+ * A solution that fits the board, or an unsolvable board whose digits are all still on this one, answers
+ * without a search: removing digits keeps a solution valid and adding digits keeps a dead board dead.
+ * Otherwise the board is copied into the scratch core and searched there, which reuses its search stack.
+ * @return true if some solution extends the board
+*/
+bool SudokuBoard::isSolvable()
+{
+    if (solutionFits())
+        return true;
+    if (!deadEnd.empty())
+    {
+        bool contains = true;
+        for (int cell = 0; cell < boardSize * boardSize && contains; cell++)
+            contains = deadEnd[cell] == Blank || deadEnd[cell] == core->getCell(cell);
+        if (contains)
+            return false;
     }
 
-    // Each iterations solves a NEW board from the input file
-    while (fin && fin.peek() != 'Z') {
-        recursiveCount = 0; // Reset # of recursive calls
-        backtracksCount = 0; // Reset # of backtrack calls
-        boardCount++; // New board to be solved
-        // Initialize sudoku matrix
-
-        sdk->initializeBoard(fin); // reads Sudoku from file
-        // Print sudoku
-        cout << "\n***** NEW SUDOKU PUZZLE... ******" << endl;
-        out << "\n***** NEW SUDOKU PUZZLE... ******" << endl;
-
-        sdk->printSudoku(out); // print the board on the terminal
-        // ******** Evaluate and print conflicts *****
-        // If found, print out the resulting solution and final conflicts
-
-        // finds and prints initial conflicts of the board
-        sdk->setConflict();
-        sdk->printConflict(out);
+    if (scratch == NULL)
+    {
+        // only the answer matters here, so the scratch search always takes the fastest settings
+        scratch = core->clone();
+        scratch->setSelection(MinRemaining);
+        scratch->setPropagation(true);
+    }
+    scratch->copyBoard(core);
+    int recur = 0, backtrack = 0;
+    scratchSolved = !scratch->contradiction() && scratch->solve(recur, backtrack);
+    if (!scratchSolved)
+    {
+        deadEnd.resize(boardSize * boardSize);
+        for (int cell = 0; cell < boardSize * boardSize; cell++)
+            deadEnd[cell] = core->getCell(cell);
+    }
+    return scratchSolved;
+}
 
+/**
+ * Looks for a naked single, then for a hidden single unit by unit, and asks isSolvable for a solution only
+ * when the board has neither. A dead board gets no hint, since a single there would only lead further into
+ * the contradiction.
+ * @param row: Receives the row of the cell
+ * @param col: Receives the column of the cell
+ * @param digit: Receives the digit
+ * @return where the hint came from, or NoHint
+*/
+HintSource SudokuBoard::nextHint(int &row, int &col, int &digit)
+{
+    if (hasContradiction())
+        return NoHint;
 
-        if (sdk->solveSudoku(recursiveCount, backtracksCount))
+    int cells = boardSize * boardSize;
+    int best = -1, fewest = boardSize + 1;
+    for (int cell = 0; cell < cells; cell++)
+    {
+        if (core->getCell(cell) != Blank)
+            continue;
+        DigitMask cand = core->candidates(cell);
+        int n = __builtin_popcountll(cand);
+        if (n == 1)
         {
-            // one more solved
-            solved++;
-            /* Print completed board
-              * print the conflicts
-              * print # of recursive calls
-              * print # of backtrack calls
-              * */
-            cout << "\nComplete Solution Found." << endl;
-            cout << "\nCompleted board ..." << endl;
-            out << "\nComplete Solution Found." << endl;
-            out << "\nCompleted board ..." << endl;
-            sdk -> printSudoku(out);
-
-            // adds recursive and backtracks to a vector
-            recursiveCount -= 1;
-            recur.push_back(recursiveCount);
-            backtr.push_back(backtracksCount);
-
-            cout << "Recursive calls: " << recursiveCount << endl;
-            cout << "Backtracks: " << backtracksCount << endl;
-            out << "Recursive calls: " << recursiveCount << endl;
-            out << "Backtracks: " << backtracksCount << endl;
-            /* Print completed board
-             * print the conflicts
-             * print # of recursive calls
-             * print # of backtrack calls
-             * */
+            row = tables->rowOf[cell];
+            col = tables->colOf[cell];
+            digit = __builtin_ctzll(cand) + 1;
+            return NakedSingleHint;
         }
-
-        else {
-            // one more not solved
-            nosolve++;
-            /* Print incompleted board */
-            cout << "\nNo Solution Found...!" << endl;
-            cout << "\nIncomplete board ..." << endl;
-            out << "\nNo Solution Found...!" << endl;
-            out << "\nIncomplete board ..." << endl;
-
+        if (n < fewest)
+        {
+            fewest = n;
+            best = cell;
         }
     }
+    if (best < 0)
+        return NoHint;
 
-    // ****** Post processing info **********
-    cout << "Number of boards solved: " << solved << endl;
-    cout << "Number of Boards with no solution: " << nosolve <<endl;
-    out << "Number of boards solved: " << solved << endl;
-    out << "Number of Boards with no solution: " << nosolve << endl;
-
-    // calculates and puts into text file recursive and backtrack info
-    cout << "Minimum # of Recursive calls: " << *min_element(recur.begin(), recur.end()) << endl;
-    cout << "Maximum # of Recursive calls: " << *max_element(recur.begin(), recur.end()) << endl;
-    cout << "Average # of Recursive calls: " << accumulate(recur.begin(), recur.end(), 0.0) / recur.size() << endl;
-    out << "Minimum # of Recursive calls: " << *min_element(recur.begin(), recur.end()) << endl;
-    out << "Maximum # of Recursive calls: " << *max_element(recur.begin(), recur.end()) << endl;
-    out << "Average # of Recursive calls: " << accumulate(recur.begin(), recur.end(), 0.0) / recur.size() << endl;
-
-    cout << "Minimum # of BackTrack calls: " << *min_element(backtr.begin(), backtr.end()) << endl;
-    cout << "Maximum # of BackTrack calls: " << *max_element(backtr.begin(), backtr.end()) << endl;
-    cout << "Average # of BackTrack calls: " << accumulate(backtr.begin(), backtr.end(), 0.0) / backtr.size() << endl;
-    out << "Minimum # of BackTrack calls: " << *min_element(backtr.begin(), backtr.end()) << endl;
-    out << "Maximum # of BackTrack calls: " << *max_element(backtr.begin(), backtr.end()) << endl;
-    out << "Average # of BackTrack calls: " << accumulate(backtr.begin(), backtr.end(), 0.0) / backtr.size() << endl;
-
-    // over
-    cout << "\n***** Solver Terminating... ******" << endl;
-    out << "\n***** Solver Terminating... ******" << endl;
+    for (int unit = 0; unit < 3 * boardSize; unit++)
+    {
+        const uint16_t* members = tables->units + unit * boardSize;
+        DigitMask once = 0, twice = 0;
+        for (int k = 0; k < boardSize; k++)
+        {
+            if (core->getCell(members[k]) != Blank)
+                continue;
+            DigitMask cand = core->candidates(members[k]);
+            twice |= once & cand;
+            once |= cand;
+        }
+        DigitMask single = once & ~twice;
+        if (single == 0)
+            continue;
+        digit = __builtin_ctzll(single) + 1;
+        for (int k = 0; k < boardSize; k++)
+            if (core->getCell(members[k]) == Blank && (core->candidates(members[k]) >> (digit - 1) & 1))
+            {
+                row = tables->rowOf[members[k]];
+                col = tables->colOf[members[k]];
+                return HiddenSingleHint;
+            }
+    }
 
-    // closes file, deletes object and ends program
-    out.close();
-    fin.close();
-    delete sdk;
-    return 0;
+    if (!isSolvable())
+        return NoHint;
+    row = tables->rowOf[best];
+    col = tables->colOf[best];
+    digit = scratch->getCell(best);
+    return SolutionHint;
 }
-
-
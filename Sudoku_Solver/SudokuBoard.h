@@ -11,32 +11,104 @@
 #include <iostream>
 #include <vector>
 #include <fstream>
-#include "d_matrix-1.h"
+#include <string>
+#include <atomic>
+#include "SudokuCore.h"
+#include "BoardTables.h"
 
 using namespace std;
 
-const int Blank = 0;
-const int SquareSize = 3;
+class ThreadPool;
+class OutputWriter;
+
+/**
+* A validity-preserving relabelling of a board: an optional transposition, then rows and columns reordered
+* within the band and stack structure, then digits renamed. Cell (r, c) of the transformed board holds
+* digits[g(rows[r], cols[c])], where g is the board, transposed first when transpose is set.
+*/
+struct BoardSymmetry
+{
+    bool transpose = false;
+    vector<int> rows; // source row of every row
+    vector<int> cols; // source column of every column
+    vector<int> digits; // new name of every digit, digits[Blank] = Blank
+};
+
+/**
+* Where a hint from nextHint comes from: the only candidate of a cell, the only place of a digit in a unit,
+* or, when neither exists, a solution of the board.
+*/
+enum HintSource { NoHint, NakedSingleHint, HiddenSingleHint, SolutionHint };
 
 class SudokuBoard
 {
 
 private:
     int boardSize, count = 0; // Size of the sudoku board
-    matrix<int> sdkMatrix; // Sudoku matrix
-    matrix<bool> c_rows; // conflict matrices for rows
-    matrix<bool> c_cols; // conflict matrices for columns
-    matrix<bool> c_sqs; // conflict matrices for squares
+    int squareSize; // Size of each square, boardSize = squareSize * squareSize
+    SudokuCore* core; // board state and search, specialized for squareSize
+    const UnitTables* tables; // row, column and square of every cell, built at compile time
 
+    // kept between the interactive calls; checked against the board before use, so they never go stale
+    SudokuCore* scratch = NULL; // search context of isSolvable, holding the last solution it found
+    bool scratchSolved = false; // scratch holds a solution
+    vector<uint8_t> deadEnd; // cells of the last board found to have no solution, empty if none
+
+    /**
+    * Tells whether the solution held by scratch still extends the board.
+    * @return True if every filled cell agrees with it.
+    */
+    bool solutionFits();
 
 public:
 
     /**
     * Constructor for SudokuBoard class.
-    * @param N The size of the board. Default value is 9.
+    * @param N The size of the board: 4, 9, 16, 25 or 36. Default value is 9.
     */
     SudokuBoard(int N = 9);
 
+    /**
+    * Copy constructor. The copy gets its own board state.
+    * @param other The board to copy.
+    */
+    SudokuBoard(const SudokuBoard& other);
+
+    /**
+    * Copy assignment. The board takes over the size, state and settings of other.
+    * @param other The board to copy.
+    * @return This board.
+    */
+    SudokuBoard& operator=(const SudokuBoard& other);
+
+    /**
+    * Destructor for SudokuBoard class.
+    */
+    ~SudokuBoard();
+
+    /**
+    * Tells whether a board size is supported.
+    * @param N The size of the board.
+    * @return True if N is 4, 9, 16, 25 or 36.
+    */
+    static bool supportedSize(int N);
+
+    /**
+    * Converts a puzzle character to a digit. Digits 1-9 are written '1'-'9' and digits 10-35 'A'-'Z'
+    * (either case). On 36 x 36 boards '0' stands for 36; on smaller boards it is a blank like '.'.
+    * @param ch The character.
+    * @param N The size of the board.
+    * @return The digit, or Blank for a blank or a character that is not a digit of the board.
+    */
+    static int symbolToDigit(char ch, int N);
+
+    /**
+    * Converts a digit to its puzzle character, the inverse of symbolToDigit.
+    * @param digit The digit, or Blank.
+    * @return The character, '.' for Blank.
+    */
+    static char digitToSymbol(int digit);
+
     /**
     * Clears the Sudoku board.
     */
@@ -48,6 +120,39 @@ public:
     */
     void initializeBoard(ifstream& fin);
 
+    /**
+    * Initializes the Sudoku board from a string holding one character per cell in row-major order.
+    * Whitespace is skipped and '.' marks a blank cell.
+    * @param cells The puzzle text.
+    */
+    void initializeBoard(const string& cells);
+
+    /**
+    * Initializes the Sudoku board from characters in memory, with the same rules as the string version.
+    * @param text The first character of the puzzle.
+    * @param length The number of characters that may be read.
+    */
+    void initializeBoard(const char* text, size_t length);
+
+    /**
+    * Initializes the Sudoku board from digits, one byte per cell in row-major order, 0 for a blank.
+    * @param digits The N x N digits.
+    */
+    void initializeDigits(const uint8_t* digits);
+
+    /**
+    * Writes the board as one character per cell in row-major order, using '.' for blanks.
+    * @return The board text, accepted by initializeBoard.
+    */
+    string toString();
+
+    /**
+    * Writes the board text into an existing string, reusing its storage, so a result kept from one puzzle to
+    * the next does not allocate.
+    * @param cells Receives the board text.
+    */
+    void toString(string &cells);
+
     /**
     * Solves the Sudoku board.
     * @param recur The number of recursive calls made during the solving process.
@@ -57,10 +162,109 @@ public:
     bool solveSudoku(int &recur, int &backtrack);
 
     /**
-    * Prints the Sudoku board to an output file.
-    * @param out The output file stream to write to.
+    * Counts the solutions of the Sudoku board up to a limit, using the same search as solveSudoku.
+    * @param limit The search stops after this many solutions; 2 checks that the solution is unique.
+    * @param recur The number of recursive calls made during the search.
+    * @param backtrack The number of times the solver backtracked during the search.
+    * @return The number of solutions found, at most limit. The board is left holding the first one.
+    */
+    long countSolutions(long limit, int &recur, int &backtrack);
+
+    /**
+    * Starts a search that continueSearch runs in slices, e.g. to time-slice long searches. Uses the same search,
+    * settings and counters as solveSudoku and countSolutions.
+    * @param limit The search stops after this many solutions: 1 to solve, 2 to check uniqueness.
     */
-    void printSudoku(ofstream& out);
+    void beginSearch(long limit = 1);
+
+    /**
+    * Continues the search started by beginSearch. The board must not be changed until the search is over.
+    * @param nodes The most nodes to visit in this slice, 0 to run to the end.
+    * @param recur The number of recursive calls made during the slice.
+    * @param backtrack The number of times the solver backtracked during the slice.
+    * @return True once the search is over; the board then holds the first solution, if any.
+    */
+    bool continueSearch(long nodes, int &recur, int &backtrack);
+
+    /**
+    * Returns the number of solutions found by the current or last search.
+    * @return The number of solutions, at most the limit.
+    */
+    long solutionsFound();
+
+    /**
+    * Selects the branching heuristic used by solveSudoku.
+    * @param order FirstEmpty for row-major order, MinRemaining for fewest candidates first.
+    */
+    void setSelection(SelectionOrder order);
+
+    /**
+    * Solves the board by splitting the top of the search tree into independent tasks on a thread pool.
+    * The first task to find a solution cancels the others. May be called from inside a pool task.
+    * @param pool The pool to run the subtrees on.
+    * @param splitDepth Number of branching levels expanded before handing subtrees to the pool.
+    * @param recur The number of recursive calls, summed over all threads.
+    * @param backtrack The number of backtracks, summed over all threads.
+    * @return True if the board is solvable, false otherwise.
+    */
+    bool solveParallel(ThreadPool &pool, int splitDepth, int &recur, int &backtrack);
+
+    /**
+    * Turns constraint propagation inside solveSudoku on or off.
+    * @param enabled True to propagate at every node of the search.
+    */
+    void setPropagation(bool enabled);
+
+    /**
+    * Repeatedly applies naked singles, hidden singles and locked candidates until nothing changes.
+    * @return False if the board was found to be contradictory, true otherwise.
+    */
+    bool propagate();
+
+    /**
+    * Returns the number of deductions made by each propagation rule since the board was loaded.
+    * @return The propagation statistics.
+    */
+    PropagationStats getPropagationStats();
+
+    /**
+    * Returns where the searches since the board was loaded spent their time, when built with SUDOKU_PROFILE.
+    * @return The search profile.
+    */
+    SearchProfile getSearchProfile();
+
+    /**
+    * Computes the canonical form of the board: the smallest text, blanks first, that any transposition, band,
+    * row, stack and column permutation and digit renaming can turn the board into. Boards that are the same
+    * up to these symmetries have the same canonical form.
+    * @param symmetry Receives a symmetry that takes the board to its canonical form.
+    * @return The canonical form in toString format, or an empty string when the board is so symmetric that
+    *         finding it would cost more than a search (e.g. a nearly empty board).
+    */
+    string canonicalForm(BoardSymmetry &symmetry);
+
+    /**
+    * Applies a symmetry to a board text of this size.
+    * @param cells The text, in toString format.
+    * @param symmetry The symmetry, as returned by canonicalForm.
+    * @return The transformed text.
+    */
+    string toCanonical(const string &cells, const BoardSymmetry &symmetry);
+
+    /**
+    * Undoes a symmetry on a board text of this size, e.g. to bring a cached solution of the canonical form
+    * back to the board it came from.
+    * @param cells The text, in toString format.
+    * @param symmetry The symmetry, as returned by canonicalForm.
+    * @return The text before the symmetry.
+    */
+    string fromCanonical(const string &cells, const BoardSymmetry &symmetry);
+
+    /**
+    * Prints the Sudoku board.
+    * @param out The writer to print to.
+    */
+    void printSudoku(OutputWriter& out);
 
     /**
     * Finds an empty cell on the Sudoku board.
@@ -81,21 +285,122 @@ public:
 
     /**
     * Finds the row of the first empty cell.
-    * @return The row of the first empty cell.
+    * @return The row of the first empty cell, or boardSize if the board is full.
     */
     int emptyFinderrow();
 
     /**
     * Finds the column of the first empty cell.
-    * @return The column of the first empty cell.
+    * @return The column of the first empty cell, or boardSize if the board is full.
     */
     int emptyFindercol();
 
     /**
-    * Prints the conflict matrices to an output file.
-    * @param out The output file stream to write to.
+    * Returns the size of the board.
+    * @return The number of rows (and columns) of the board.
+    */
+    int getBoardSize();
+
+    /**
+    * Returns the size of the squares of the board.
+    * @return The number of rows (and columns) of each square.
+    */
+    int getSquareSize();
+
+    /**
+    * Returns the digit stored in a cell.
+    * @param row The row of the cell.
+    * @param col The column of the cell.
+    * @return The digit, or Blank if the cell is empty.
+    */
+    int getCell(int row, int col);
+
+    /**
+    * Writes a digit into a cell, keeping the conflict bitmasks up to date.
+    * @param row The row of the cell.
+    * @param col The column of the cell.
+    * @param number The digit to write, or Blank to empty the cell.
+    */
+    void setCell(int row, int col, int number);
+
+    /**
+    * Computes the digits that can legally be placed in a cell.
+    * @param row The row of the cell.
+    * @param col The column of the cell.
+    * @return Bitmask of the candidate digits (bit k-1 set when k is legal).
+    */
+    DigitMask candidates(int row, int col);
+
+    /**
+    * Finds the index of the square containing a cell, numbered row-major from 0.
+    * @param row The row of the cell.
+    * @param col The column of the cell.
+    * @return The square index.
+    */
+    int squareIndex(int row, int col);
+
+    /**
+    * Places a digit for an interactive user, keeping the masks and candidates of every cell up to date.
+    * A digit that repeats one of its row, column or square is refused.
+    * @param row The row of the cell.
+    * @param col The column of the cell.
+    * @param digit The digit; it replaces the cell's digit, if any.
+    * @return True if the digit was placed, false if it conflicts and the board is unchanged.
+    */
+    bool placeDigit(int row, int col, int digit);
+
+    /**
+    * Empties a cell.
+    * @param row The row of the cell.
+    * @param col The column of the cell.
+    */
+    void removeDigit(int row, int col);
+
+    /**
+    * Finds the cell that stops a digit from going into a cell.
+    * @param row The row of the cell.
+    * @param col The column of the cell.
+    * @param digit The digit.
+    * @return The index (row * N + col) of a peer holding the digit, or -1 if the digit fits.
+    */
+    int findConflict(int row, int col, int digit);
+
+    /**
+    * Tells whether no row, column or square holds a digit twice.
+    * @return True if the filled cells agree with each other.
+    */
+    bool isConsistent();
+
+    /**
+    * Tells whether the board is dead without searching: a blank cell has no candidate left, or a row, column or
+    * square has no place left for one of its missing digits.
+    * @return True if the board cannot be finished.
+    */
+    bool hasContradiction();
+
+    /**
+    * Tells whether the board can still be completed. The search runs on a context kept from call to call, and
+    * is skipped when the solution found last time still fits or the board only added digits to one found
+    * unsolvable.
+    * @return True if some solution extends the board.
+    */
+    bool isSolvable();
+
+    /**
+    * Finds the next digit to fill: a naked single, else a hidden single, else the digit of a solution in the
+    * blank cell with the fewest candidates.
+    * @param row Receives the row of the cell.
+    * @param col Receives the column of the cell.
+    * @param digit Receives the digit.
+    * @return Where the hint came from, NoHint if the board is full, has a contradiction or has no solution.
+    */
+    HintSource nextHint(int &row, int &col, int &digit);
+
+    /**
+    * Prints the conflict matrices.
+    * @param out The writer to print to.
     */
-    void printConflict(ofstream& out);
+    void printConflict(OutputWriter& out);
 
     /**
     * Sets the conflict matrices for rows, columns, and squares.
@@ -103,10 +408,10 @@ public:
     void setConflict();
 
     /**
-    * Finds the index of a given cell in the Sudoku matrix.
+    * Finds the square containing a given cell. Same as squareIndex.
     * @param row The row of the cell.
     * @param col The column of the cell.
-    * @return The index of the cell in the Sudoku matrix.
+    * @return The index of the square, numbered row-major from 0.
     */
     int findLocation(int row, int col);
 };
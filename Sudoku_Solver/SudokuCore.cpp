@@ -0,0 +1,793 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author : Ajinkya Joshi, Anthony Chamoun
+* Date : March 15, 2023
+* File name : SudokuCore.cpp - Board state and search for every board size
+* Purpose : One template instantiation per square size (4x4 up to 36x36)
+****************************************************************************/
+
+#include "SudokuCore.h"
+#include "BoardTables.h"
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#ifdef SUDOKU_PROFILE
+#include <chrono>
+#endif
+
+using namespace std;
+
+// times a statement into a field of the profile; without SUDOKU_PROFILE it is just the statement
+#ifdef SUDOKU_PROFILE
+#define PROFILE_PHASE(field, statement) \
+    { \
+        chrono::steady_clock::time_point phaseStart = chrono::steady_clock::now(); \
+        statement; \
+        profile.field += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - phaseStart).count(); \
+    }
+#define PROFILE_DEPTH(d) \
+    if ((d) > profile.maxDepth) \
+        profile.maxDepth = (d)
+#else
+#define PROFILE_PHASE(field, statement) statement
+#define PROFILE_DEPTH(d)
+#endif
+
+/**
+* Board state and search for boards made of Box x Box squares. N and the number of cells are compile-time
+* constants, so the loops over a unit or over the board are fully unrolled or strength-reduced by the
+* compiler, and the unit membership of every cell comes from tables the compiler builds for each square size.
+*/
+template <int Box>
+class BoxCore : public SudokuCore
+{
+
+private:
+    static const int N = Box * Box;
+    static const int Cells = N * N;
+
+    // narrowest unsigned type holding one bit per digit
+    typedef typename conditional<(N <= 16), uint16_t,
+            typename conditional<(N <= 32), uint32_t, uint64_t>::type>::type Mask;
+    static const Mask FullMask = (Mask)(~0ULL >> (64 - N));
+
+    // row, column and square of every cell and the cells of every unit, built by the compiler
+    static constexpr const BoardTables<Box> &tables = boardTables<Box>;
+
+    /**
+    * Everything the search needs to know about a board, in one flat, trivially copyable block so a branch
+    * can start from a plain copy of its parent instead of undoing changes on the way back. The cells, unit
+    * masks and blank counts come first; for 9 x 9 they fill the first three cache lines, followed by the
+    * per-cell eliminations that only propagation writes.
+    */
+    struct alignas(64) BoardState
+    {
+        uint8_t cells[Cells]; // digit of every cell, Blank when empty
+        Mask rows[N]; // digits used in each row
+        Mask cols[N]; // digits used in each column
+        Mask sqs[N]; // digits used in each square
+        uint8_t rowBlanks[N]; // number of blanks left in each row
+        uint8_t colBlanks[N]; // number of blanks left in each column
+        uint8_t sqBlanks[N]; // number of blanks left in each square
+        uint16_t blanks; // number of blank cells
+        uint16_t firstBlank; // every cell before this one is filled
+        Mask elim[Cells]; // digits ruled out of each cell by locked candidates
+    };
+    static_assert(is_trivially_copyable<BoardState>::value, "BoardState must be copyable with memcpy");
+
+    BoardState state; // the board as seen through the public interface
+    /**
+    * The cell a search node branches on and the digits not tried there yet.
+    */
+    struct Branch
+    {
+        int cell;
+        Mask avail;
+    };
+
+    vector<BoardState> frames; // one state per search depth reached so far, kept from search to search
+    vector<Branch> branches; // the branch taken at each search depth, sized for the deepest possible search
+    int elimFrames = 0; // frames, from the first, holding the eliminations of frames[0]
+    long solutions = 0; // complete boards reached by the current search
+    long solutionLimit = 1; // the search stops after this many solutions
+    int depth = 0; // the node the search continues from
+    bool entering = false; // frames[depth] has not been visited yet
+    bool searching = false; // a search was started and is not over
+
+    /**
+    * Places a digit in a blank cell and updates the masks and blank counts.
+    * @param s The state to change.
+    * @param cell The cell index.
+    * @param number The digit.
+    */
+    static void assign(BoardState &s, int cell, int number)
+    {
+        Mask bit = (Mask)1 << (number - 1);
+        int r = tables.rowOf[cell], c = tables.colOf[cell], sq = tables.sqOf[cell];
+        s.cells[cell] = number;
+        s.rows[r] |= bit;
+        s.cols[c] |= bit;
+        s.sqs[sq] |= bit;
+        s.rowBlanks[r]--;
+        s.colBlanks[c]--;
+        s.sqBlanks[sq]--;
+        s.blanks--;
+    }
+
+    /**
+    * Empties a filled cell and undoes its marks in the masks and blank counts.
+    * @param s The state to change.
+    * @param cell The cell index.
+    */
+    static void unassign(BoardState &s, int cell)
+    {
+        Mask bit = ~((Mask)1 << (s.cells[cell] - 1));
+        int r = tables.rowOf[cell], c = tables.colOf[cell], sq = tables.sqOf[cell];
+        s.cells[cell] = Blank;
+        if (cell < s.firstBlank)
+            s.firstBlank = cell;
+        s.rows[r] &= bit;
+        s.cols[c] &= bit;
+        s.sqs[sq] &= bit;
+        s.rowBlanks[r]++;
+        s.colBlanks[c]++;
+        s.sqBlanks[sq]++;
+        s.blanks++;
+    }
+
+    /**
+    * Candidates of a cell: the complement of its row, column, square and eliminated digits.
+    * @param s The state.
+    * @param cell The cell index.
+    * @return Bitmask of the legal digits.
+    */
+    static Mask candidatesOf(const BoardState &s, int cell)
+    {
+        return ~(s.rows[tables.rowOf[cell]] | s.cols[tables.colOf[cell]] | s.sqs[tables.sqOf[cell]] | s.elim[cell]) & FullMask;
+    }
+
+    /**
+    * Chooses the next blank cell to branch on.
+    * FirstEmpty takes the first blank in row-major order. MinRemaining keeps the blank with the fewest
+    * candidates; ties go to the cell whose row, column and square hold the most blanks.
+    * @param s The state; its firstBlank is moved up to the first blank cell.
+    * @param cell Set to the chosen cell.
+    * @return False if no blank cell is left, true otherwise.
+    */
+    bool nextCell(BoardState &s, int &cell)
+    {
+        if (s.blanks == 0)
+            return false;
+
+        // filling cells never creates a blank, so later copies of this state can start scanning here
+        while (s.cells[s.firstBlank] != Blank)
+            s.firstBlank++;
+        if (selection == FirstEmpty)
+        {
+            cell = s.firstBlank;
+            return true;
+        }
+
+        cell = s.firstBlank;
+        int bestCount = N + 1;
+        int bestDegree = -1;
+        for (int c = s.firstBlank; c < Cells; c++)
+        {
+            if (s.cells[c] != Blank)
+                continue;
+            int options = __builtin_popcountll(candidatesOf(s, c));
+            if (options > bestCount)
+                continue;
+
+            int degree = s.rowBlanks[tables.rowOf[c]] + s.colBlanks[tables.colOf[c]] + s.sqBlanks[tables.sqOf[c]];
+            if (options < bestCount || degree > bestDegree)
+            {
+                cell = c;
+                bestCount = options;
+                bestDegree = degree;
+                // a dead end or a forced cell cannot be beaten
+                if (options <= 1)
+                    break;
+            }
+        }
+        return true;
+    }
+
+    /**
+    * Rules digits out of a cell.
+    * @param s The state to change.
+    * @param cell The cell index.
+    * @param digits The digits to rule out; they must currently be candidates of the cell.
+    */
+    void eliminate(BoardState &s, int cell, Mask digits)
+    {
+        s.elim[cell] |= digits;
+        propStats.lockedEliminations += __builtin_popcountll(digits);
+    }
+
+    /**
+    * Pointing and claiming. For every square, a digit whose candidates all lie in one row (or column) of the
+    * square cannot appear elsewhere in that row (or column). For every row and column, a digit whose
+    * candidates all lie in one square cannot appear elsewhere in that square.
+    * @param s The state to change.
+    * @return True if at least one candidate was eliminated.
+    */
+    bool lockedCandidates(BoardState &s)
+    {
+        bool progress = false;
+        Mask lines[N], others[N];
+
+        // pointing: square -> row / column
+        for (int sq = 0; sq < N; sq++)
+        {
+            int top = (sq / Box) * Box;
+            int lft = (sq % Box) * Box;
+            for (int d = 0; d < N; d++)
+            {
+                lines[d] = 0;
+                others[d] = 0;
+            }
+            for (int k = 0; k < N; k++)
+            {
+                int cell = tables.units[2 * N + sq][k];
+                if (s.cells[cell] != Blank)
+                    continue;
+                for (Mask m = candidatesOf(s, cell); m != 0; m &= m - 1)
+                {
+                    int d = __builtin_ctzll(m);
+                    lines[d] |= (Mask)1 << (tables.rowOf[cell] - top);
+                    others[d] |= (Mask)1 << (tables.colOf[cell] - lft);
+                }
+            }
+            for (int d = 0; d < N; d++)
+            {
+                Mask bit = (Mask)1 << d;
+                if (lines[d] != 0 && (lines[d] & (lines[d] - 1)) == 0)
+                {
+                    int r = top + __builtin_ctzll(lines[d]);
+                    for (int k = 0; k < N; k++)
+                    {
+                        int cell = tables.units[r][k];
+                        if (tables.sqOf[cell] != sq && s.cells[cell] == Blank && (candidatesOf(s, cell) & bit))
+                        {
+                            eliminate(s, cell, bit);
+                            progress = true;
+                        }
+                    }
+                }
+                if (others[d] != 0 && (others[d] & (others[d] - 1)) == 0)
+                {
+                    int c = lft + __builtin_ctzll(others[d]);
+                    for (int k = 0; k < N; k++)
+                    {
+                        int cell = tables.units[N + c][k];
+                        if (tables.sqOf[cell] != sq && s.cells[cell] == Blank && (candidatesOf(s, cell) & bit))
+                        {
+                            eliminate(s, cell, bit);
+                            progress = true;
+                        }
+                    }
+                }
+            }
+        }
+
+        // claiming: row / column -> square
+        for (int unit = 0; unit < 2 * N; unit++)
+        {
+            for (int d = 0; d < N; d++)
+                lines[d] = 0;
+            for (int k = 0; k < N; k++)
+            {
+                int cell = tables.units[unit][k];
+                if (s.cells[cell] != Blank)
+                    continue;
+                for (Mask m = candidatesOf(s, cell); m != 0; m &= m - 1)
+                    lines[__builtin_ctzll(m)] |= (Mask)1 << (k / Box);
+            }
+            for (int d = 0; d < N; d++)
+            {
+                if (lines[d] == 0 || (lines[d] & (lines[d] - 1)) != 0)
+                    continue;
+
+                Mask bit = (Mask)1 << d;
+                int sq = tables.sqOf[tables.units[unit][__builtin_ctzll(lines[d]) * Box]];
+                for (int k = 0; k < N; k++)
+                {
+                    int cell = tables.units[2 * N + sq][k];
+                    bool inLine = (unit < N) ? (tables.rowOf[cell] == unit) : (tables.colOf[cell] == unit - N);
+                    if (!inLine && s.cells[cell] == Blank && (candidatesOf(s, cell) & bit))
+                    {
+                        eliminate(s, cell, bit);
+                        progress = true;
+                    }
+                }
+            }
+        }
+        return progress;
+    }
+
+    /**
+    * Runs the propagation rules to a fixed point, cheapest rule first: naked singles, then hidden singles,
+    * then locked candidates. After any change the loop starts again from naked singles.
+    * @param s The state to change.
+    * @return False if some cell has no candidate left or some digit has no place left in a unit.
+    */
+    bool propagateState(BoardState &s)
+    {
+        bool changed = true;
+        while (changed)
+        {
+            changed = false;
+
+            // naked singles
+            for (int cell = 0; cell < Cells; cell++)
+            {
+                if (s.cells[cell] != Blank)
+                    continue;
+                Mask m = candidatesOf(s, cell);
+                if (m == 0)
+                    return false;
+                if ((m & (m - 1)) == 0)
+                {
+                    assign(s, cell, __builtin_ctzll(m) + 1);
+                    propStats.nakedSingles++;
+                    changed = true;
+                }
+            }
+            if (changed)
+                continue;
+
+            // hidden singles - digits that appear as a candidate exactly once in a unit
+            for (int unit = 0; unit < 3 * N; unit++)
+            {
+                Mask once = 0, twice = 0, placed = 0;
+                for (int k = 0; k < N; k++)
+                {
+                    int cell = tables.units[unit][k];
+                    if (s.cells[cell] != Blank)
+                    {
+                        placed |= (Mask)1 << (s.cells[cell] - 1);
+                        continue;
+                    }
+                    Mask m = candidatesOf(s, cell);
+                    twice |= once & m;
+                    once |= m;
+                }
+                Mask missing = FullMask & ~placed;
+                if (missing & ~once)
+                    return false;
+
+                Mask hidden = once & ~twice & missing;
+                for (int k = 0; hidden != 0 && k < N; k++)
+                {
+                    int cell = tables.units[unit][k];
+                    if (s.cells[cell] != Blank)
+                        continue;
+                    Mask m = candidatesOf(s, cell) & hidden;
+                    if (m == 0)
+                        continue;
+                    // one cell cannot be the only home of two digits
+                    if ((m & (m - 1)) != 0)
+                        return false;
+                    assign(s, cell, __builtin_ctzll(m) + 1);
+                    propStats.hiddenSingles++;
+                    hidden &= ~m;
+                    changed = true;
+                }
+            }
+            if (changed)
+                continue;
+
+            changed = lockedCandidates(s);
+        }
+        return true;
+    }
+
+    /**
+    * Search on the frames with an explicit stack instead of recursion. frames[d] is the board at depth d, each
+    * child being a copy of its parent with one more digit placed, so going back up needs no undo; branches[d]
+    * holds the cell branched on at depth d and the digits not tried there yet. The first complete board reached
+    * is copied into state. The search may stop before visiting a node and continue from it on the next call.
+    * @param nodes The most nodes to visit in this call, 0 for no limit.
+    * @param recur The number of nodes visited.
+    * @param backtrack The number of failed branches.
+    * @return True once the search is over: solutionLimit solutions were found or the tree was exhausted.
+    */
+    bool run(long nodes, int &recur, int &backtrack)
+    {
+        if (!searching)
+            return true;
+
+        int d = depth;
+        bool enter = entering;
+        bool finished = false;
+        long visited = 0;
+        int failed = 0;
+        for (;;)
+        {
+            if (enter)
+            {
+                // out of budget: this node is the first one visited on the next call
+                if (nodes > 0 && visited >= nodes)
+                    break;
+                visited++;
+                enter = false;
+                PROFILE_DEPTH(d);
+
+                // another thread already solved the puzzle this subtree belongs to, or deduction ran into
+                // a contradiction
+                BoardState &s = frames[d];
+                bool dead = cancel != NULL && cancel->load(memory_order_relaxed);
+                if (!dead && propagation)
+                    PROFILE_PHASE(propagateNanos, dead = !propagateState(s));
+                int cell;
+                bool blank = false;
+                if (!dead)
+                    PROFILE_PHASE(selectNanos, blank = nextCell(s, cell));
+                if (!dead && !blank)
+                {
+                    // if there are no empty cells left, the board is a solution
+                    if (solutions == 0)
+                        state = s;
+                    solutions++;
+                    if (solutions >= solutionLimit)
+                    {
+                        finished = true;
+                        break;
+                    }
+                    dead = true;
+                }
+                if (!dead)
+                {
+                    // every legal value for the cell in one mask, tried from the lowest digit up
+                    branches[d].cell = cell;
+                    PROFILE_PHASE(candidateNanos, branches[d].avail = candidatesOf(s, cell));
+                }
+                else if (d == 0)
+                {
+                    finished = true;
+                    break;
+                }
+                else
+                {
+                    d--;
+                    failed++;
+                }
+            }
+
+            // if all possible values have been tried, the node fails and its parent moves on
+            Branch &b = branches[d];
+            if (b.avail == 0)
+            {
+                if (d == 0)
+                {
+                    finished = true;
+                    break;
+                }
+                d--;
+                failed++;
+                continue;
+            }
+            int number = __builtin_ctzll(b.avail) + 1;
+            int cell = b.cell;
+            b.avail &= b.avail - 1;
+
+            // frames are only made as deep as a search goes; a 36 x 36 board has 12 KB of them per level
+            if (d + 1 == (int)frames.size())
+                frames.resize(d + 2);
+            // without propagation the eliminations never change, so a depth that already holds them only
+            // gets the part before them
+            if (propagation)
+                frames[d + 1] = frames[d];
+            else if (d + 1 >= elimFrames)
+            {
+                frames[d + 1] = frames[d];
+                elimFrames = d + 2;
+            }
+            else
+                memcpy(&frames[d + 1], &frames[d], offsetof(BoardState, elim));
+            assign(frames[d + 1], cell, number);
+            d++;
+            enter = true;
+        }
+
+        recur += visited;
+        backtrack += failed;
+        depth = d;
+        entering = enter;
+        searching = !finished;
+        return finished;
+    }
+
+    /**
+    * Expands the top levels of the search tree from a state, keeping a core for each node of the split depth.
+    * @param s The state of this node; changed in place.
+    * @param depth The number of levels still to expand.
+    * @param leaves Receives the new cores.
+    * @param recur The number of expanded nodes, not counting the leaves, which their own searches count.
+    * @param backtrack The number of dead branches.
+    * @return True if the expansion completed the board; state then holds the solution.
+    */
+    bool expand(BoardState &s, int depth, vector<SudokuCore*> &leaves, int &recur, int &backtrack)
+    {
+        recur += 1;
+
+        if (propagation && !propagateState(s))
+        {
+            return false;
+        }
+
+        int cell;
+        if (!nextCell(s, cell))
+        {
+            state = s;
+            return true;
+        }
+
+        if (depth == 0)
+        {
+            // the leaf's own search visits this node again and counts it there
+            recur -= 1;
+            BoxCore<Box>* leaf = new BoxCore<Box>(*this, s);
+            leaves.push_back(leaf);
+            return false;
+        }
+
+        int before = leaves.size();
+        Mask avail = candidatesOf(s, cell);
+        while (avail != 0)
+        {
+            int number = __builtin_ctzll(avail) + 1;
+            avail &= avail - 1;
+
+            BoardState child = s;
+            assign(child, cell, number);
+            if (expand(child, depth - 1, leaves, recur, backtrack))
+            {
+                return true;
+            }
+        }
+
+        // nothing below this node survived to the split depth
+        if ((int)leaves.size() == before)
+            backtrack++;
+        return false;
+    }
+
+    /**
+    * Creates a core with the settings of another core and the given board.
+    * @param other The core whose settings are copied.
+    * @param s The board.
+    */
+    BoxCore(const BoxCore<Box> &other, const BoardState &s) : SudokuCore(other), state(s)
+    {
+    }
+
+public:
+
+    BoxCore()
+    {
+        clear();
+    }
+
+    SudokuCore* clone()
+    {
+        return new BoxCore<Box>(*this, state);
+    }
+
+    void clear()
+    {
+        memset(&state, 0, sizeof(state));
+        for (int i = 0; i < N; i++)
+        {
+            state.rowBlanks[i] = N;
+            state.colBlanks[i] = N;
+            state.sqBlanks[i] = N;
+        }
+        state.blanks = Cells;
+        propStats = PropagationStats();
+        profile = SearchProfile();
+    }
+
+    int getCell(int cell)
+    {
+        return state.cells[cell];
+    }
+
+    void setCell(int cell, int number)
+    {
+        if (state.cells[cell] != Blank)
+            unassign(state, cell);
+        if (number != Blank)
+            assign(state, cell, number);
+    }
+
+    DigitMask candidates(int cell)
+    {
+        return candidatesOf(state, cell);
+    }
+
+    DigitMask rowMask(int row)
+    {
+        return state.rows[row];
+    }
+
+    DigitMask colMask(int col)
+    {
+        return state.cols[col];
+    }
+
+    DigitMask squareMask(int sq)
+    {
+        return state.sqs[sq];
+    }
+
+    void rebuild()
+    {
+        BoardState s;
+        memset(&s, 0, sizeof(s));
+        for (int i = 0; i < N; i++)
+        {
+            s.rowBlanks[i] = N;
+            s.colBlanks[i] = N;
+            s.sqBlanks[i] = N;
+        }
+        s.blanks = Cells;
+        for (int cell = 0; cell < Cells; cell++)
+            if (state.cells[cell] != Blank)
+                assign(s, cell, state.cells[cell]);
+        state = s;
+    }
+
+    void copyBoard(SudokuCore* other)
+    {
+        state = static_cast<BoxCore<Box>*>(other)->state;
+        searching = false;
+    }
+
+    bool contradiction()
+    {
+        for (int cell = 0; cell < Cells; cell++)
+            if (state.cells[cell] == Blank && candidatesOf(state, cell) == 0)
+                return true;
+        for (int unit = 0; unit < 3 * N; unit++)
+        {
+            Mask seen = 0;
+            for (int k = 0; k < N; k++)
+            {
+                int cell = tables.units[unit][k];
+                seen |= (state.cells[cell] == Blank) ? candidatesOf(state, cell) : (Mask)1 << (state.cells[cell] - 1);
+            }
+            if (seen != FullMask)
+                return true;
+        }
+        return false;
+    }
+
+    bool solve(int &recur, int &backtrack)
+    {
+        startSearch(1);
+        run(0, recur, backtrack);
+        return solutions > 0;
+    }
+
+    long countSolutions(long limit, int &recur, int &backtrack)
+    {
+        startSearch(limit);
+        run(0, recur, backtrack);
+        return solutions;
+    }
+
+    void startSearch(long limit)
+    {
+        // the search can go at most one level deeper than there are blanks; the room is reserved, which
+        // leaves the pages untouched, and frames are made as the search gets there
+        if ((int)branches.size() < state.blanks + 2)
+        {
+            branches.resize(state.blanks + 2);
+            frames.reserve(state.blanks + 2);
+        }
+        if (frames.empty())
+            frames.resize(1);
+        // the frames keep the eliminations of the last search without propagation, which are still good if
+        // this search starts from the same ones
+        if (propagation || memcmp(frames[0].elim, state.elim, sizeof(state.elim)) != 0)
+            elimFrames = 1;
+        frames[0] = state;
+        solutions = 0;
+        solutionLimit = limit;
+        depth = 0;
+        entering = true;
+        searching = true;
+    }
+
+    bool resumeSearch(long nodes, int &recur, int &backtrack)
+    {
+        return run(nodes, recur, backtrack);
+    }
+
+    long solutionCount()
+    {
+        return solutions;
+    }
+
+    bool propagate()
+    {
+        return propagateState(state);
+    }
+
+    bool splitSearch(int depth, vector<SudokuCore*> &leaves, int &recur, int &backtrack)
+    {
+        BoardState root = state;
+        return expand(root, depth, leaves, recur, backtrack);
+    }
+};
+
+
+/**************************************************************************
+ * SudokuCore
+****************************************************************************/
+
+/**
+ * Creates the core specialized for the square size.
+ * @param squareSize: Side of a square
+ * @return The new core, or NULL if no specialization exists for the size
+*/
+SudokuCore* SudokuCore::create(int squareSize)
+{
+    switch (squareSize)
+    {
+    case 2: return new BoxCore<2>();
+    case 3: return new BoxCore<3>();
+    case 4: return new BoxCore<4>();
+    case 5: return new BoxCore<5>();
+    case 6: return new BoxCore<6>();
+    default: return NULL;
+    }
+}
+
+/**
+ * Selects the branching heuristic.
+ * @param order The cell selection order.
+*/
+void SudokuCore::setSelection(SelectionOrder order)
+{
+    selection = order;
+}
+
+/**
+ * Turns constraint propagation inside solve on or off.
+ * @param enabled True to propagate at every node.
+*/
+void SudokuCore::setPropagation(bool enabled)
+{
+    propagation = enabled;
+}
+
+/**
+ * Sets the flag that makes solve give up early.
+ * @param flag The shared flag, or NULL.
+*/
+void SudokuCore::setCancel(atomic<bool>* flag)
+{
+    cancel = flag;
+}
+
+/**
+ * Returns the deductions made by each propagation rule since the board was cleared.
+ * @return The propagation statistics.
+*/
+PropagationStats SudokuCore::getPropagationStats()
+{
+    return propStats;
+}
+
+/**
+ * Returns where the searches since the board was cleared spent their time.
+ * @return The search profile.
+*/
+SearchProfile SudokuCore::getSearchProfile()
+{
+    return profile;
+}
@@ -0,0 +1,252 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author          :Ajinkya Joshi, Anthony Chamoun
+* Date            :March 15th, 2023
+* File name       :SudokuCore.h
+* Purpose         :Board state and search engine behind SudokuBoard,
+*                  specialized at compile time for each square size.
+ **************************************************************************/
+
+#ifndef SUDOKUCORE_H
+#define SUDOKUCORE_H
+#include <vector>
+#include <atomic>
+#include <cstddef>
+
+using namespace std;
+
+const int Blank = 0;
+
+/**
+* Bitmask of digits, bit k-1 standing for digit k. Wide enough for a 36 x 36 board.
+*/
+typedef unsigned long long DigitMask;
+
+/**
+* Order in which the solver picks the next blank cell to branch on.
+* FirstEmpty takes the first blank in row-major order (the original behaviour).
+* MinRemaining takes the blank with the fewest legal digits, breaking ties by the
+* number of blanks sharing its row, column and square.
+*/
+enum SelectionOrder { FirstEmpty, MinRemaining };
+
+/**
+* Number of deductions made by each propagation rule while solving one puzzle.
+* Deductions made on branches that were later abandoned are included.
+*/
+struct PropagationStats
+{
+    int nakedSingles = 0; // cells filled because only one digit fit
+    int hiddenSingles = 0; // cells filled because a digit fit nowhere else in a unit
+    int lockedEliminations = 0; // candidates removed by pointing/claiming
+};
+
+/**
+* Where the search spent its time on one puzzle. The phase times are only measured when the program is built
+* with -DSUDOKU_PROFILE; otherwise the search is compiled without the timers and every field stays 0. The
+* hardware counters are filled in by PerfCounters and stay -1 when they are not available.
+*/
+struct SearchProfile
+{
+    int maxDepth = 0; // deepest search node visited
+    long long selectNanos = 0; // choosing the cell to branch on
+    long long candidateNanos = 0; // computing the digits to try in that cell
+    long long propagateNanos = 0; // constraint propagation at the nodes
+    long long cycles = -1;
+    long long instructions = -1;
+    long long branchMisses = -1;
+};
+
+#ifdef SUDOKU_PROFILE
+const bool ProfileEnabled = true;
+#else
+const bool ProfileEnabled = false;
+#endif
+
+class SudokuCore
+{
+
+/*
+ * Cells are addressed by index (row * N + col). The implementation for each square size is a template in
+ * SudokuCore.cpp, so every loop bound and table in the hot path is a compile-time constant. SudokuBoard
+ * talks to it only through this interface, one virtual call per operation rather than per search node.
+*/
+protected:
+    SelectionOrder selection = FirstEmpty; // branching heuristic used by solve
+    bool propagation = false; // run constraint propagation at every node of solve
+    atomic<bool>* cancel = NULL; // when set and true, solve unwinds without a solution
+    PropagationStats propStats; // deductions made since the board was cleared
+    SearchProfile profile; // phase times since the board was cleared, with SUDOKU_PROFILE only
+
+public:
+
+    virtual ~SudokuCore() {}
+
+    /**
+    * Creates the core for a board made of squareSize x squareSize squares.
+    * @param squareSize Side of a square: 2, 3, 4, 5 or 6.
+    * @return The new core, or NULL if the size is not supported.
+    */
+    static SudokuCore* create(int squareSize);
+
+    /**
+    * Copies the core, including its board, bitmasks and settings.
+    * @return The new copy.
+    */
+    virtual SudokuCore* clone() = 0;
+
+    /**
+    * Empties every cell and resets the bitmasks and statistics.
+    */
+    virtual void clear() = 0;
+
+    /**
+    * Returns the digit stored in a cell.
+    * @param cell The cell index.
+    * @return The digit, or Blank.
+    */
+    virtual int getCell(int cell) = 0;
+
+    /**
+    * Writes a digit into a cell, replacing whatever was there.
+    * @param cell The cell index.
+    * @param number The digit, or Blank to empty the cell.
+    */
+    virtual void setCell(int cell, int number) = 0;
+
+    /**
+    * Computes the digits that can legally be placed in a cell.
+    * @param cell The cell index.
+    * @return Bitmask of the candidate digits.
+    */
+    virtual DigitMask candidates(int cell) = 0;
+
+    /**
+    * Returns the digits used in a row.
+    * @param row The row.
+    * @return Bitmask of the digits.
+    */
+    virtual DigitMask rowMask(int row) = 0;
+
+    /**
+    * Returns the digits used in a column.
+    * @param col The column.
+    * @return Bitmask of the digits.
+    */
+    virtual DigitMask colMask(int col) = 0;
+
+    /**
+    * Returns the digits used in a square.
+    * @param sq The square, numbered row-major.
+    * @return Bitmask of the digits.
+    */
+    virtual DigitMask squareMask(int sq) = 0;
+
+    /**
+    * Recomputes the bitmasks and blank counts from the cells and drops propagation eliminations.
+    */
+    virtual void rebuild() = 0;
+
+    /**
+    * Replaces the board with the board of another core of the same size, keeping this core's settings and
+    * search stack, so a core kept for repeated searches does not allocate.
+    * @param other The core to copy the board from.
+    */
+    virtual void copyBoard(SudokuCore* other) = 0;
+
+    /**
+    * Tells whether the board is dead without searching: a blank cell has no candidate, or a unit has no
+    * place left for one of its missing digits.
+    * @return True if the board cannot be finished.
+    */
+    virtual bool contradiction() = 0;
+
+    /**
+    * Backtracking search, run to the end.
+    * @param recur The number of recursive calls made during the solving process.
+    * @param backtrack The number of times the solver backtracked during the solving process.
+    * @return True if the board is solvable, false otherwise.
+    */
+    virtual bool solve(int &recur, int &backtrack) = 0;
+
+    /**
+    * Runs the same search as solve but keeps going after the first solution, so a limit of 2 tells a
+    * puzzle with a unique solution from one with several.
+    * @param limit The search stops after this many solutions.
+    * @param recur The number of recursive calls made during the search.
+    * @param backtrack The number of failed branches.
+    * @return The number of solutions found, at most limit. The core holds the first one, if any.
+    */
+    virtual long countSolutions(long limit, int &recur, int &backtrack) = 0;
+
+    /**
+    * Prepares a search that resumeSearch runs in slices. The search stack is allocated here, so the slices
+    * never allocate.
+    * @param limit The search stops after this many solutions.
+    */
+    virtual void startSearch(long limit) = 0;
+
+    /**
+    * Continues the search started by startSearch for at most a number of nodes. The board must not be changed
+    * until the search is over.
+    * @param nodes The most nodes to visit, 0 to run to the end.
+    * @param recur The number of nodes visited.
+    * @param backtrack The number of failed branches.
+    * @return True once the search is over, false if it stopped on the node budget.
+    */
+    virtual bool resumeSearch(long nodes, int &recur, int &backtrack) = 0;
+
+    /**
+    * Returns the number of solutions the current or last search has found.
+    * @return The number of solutions, at most the limit. The core holds the first one, if any.
+    */
+    virtual long solutionCount() = 0;
+
+    /**
+    * Applies naked singles, hidden singles and locked candidates until nothing changes.
+    * @return False if the board was found to be contradictory, true otherwise.
+    */
+    virtual bool propagate() = 0;
+
+    /**
+    * Expands the search tree to a fixed depth and stores a copy of the core at every live node of that depth.
+    * @param depth The depth still to expand.
+    * @param leaves Receives the copies; the caller deletes them.
+    * @param recur The number of nodes expanded, not counting the leaves, which their own searches count.
+    * @param backtrack The number of dead branches met during the expansion.
+    * @return True if a complete solution was reached during the expansion; the core is left holding it.
+    */
+    virtual bool splitSearch(int depth, vector<SudokuCore*> &leaves, int &recur, int &backtrack) = 0;
+
+    /**
+    * Selects the branching heuristic.
+    * @param order The cell selection order.
+    */
+    void setSelection(SelectionOrder order);
+
+    /**
+    * Turns constraint propagation inside solve on or off.
+    * @param enabled True to propagate at every node.
+    */
+    void setPropagation(bool enabled);
+
+    /**
+    * Sets the flag that makes solve give up early.
+    * @param flag The shared flag, or NULL.
+    */
+    void setCancel(atomic<bool>* flag);
+
+    /**
+    * Returns the deductions made by each propagation rule since the board was cleared.
+    * @return The propagation statistics.
+    */
+    PropagationStats getPropagationStats();
+
+    /**
+    * Returns where the searches since the board was cleared spent their time.
+    * @return The profile; all zeros unless built with SUDOKU_PROFILE.
+    */
+    SearchProfile getSearchProfile();
+};
+
+#endif
@@ -0,0 +1,201 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author : Ajinkya Joshi, Anthony Chamoun
+* Date : March 15, 2023
+* File name : ThreadPool.cpp - Work-stealing thread pool
+* Purpose : Runs solver tasks on all cores
+****************************************************************************/
+
+#include "ThreadPool.h"
+
+using namespace std;
+
+// a thread is a worker of at most one pool; every other pool treats it as an outside thread
+static thread_local const ThreadPool* currentPool = NULL; // pool owning this thread
+static thread_local int currentWorker = -1; // index of this thread in currentPool
+
+/**************************************************************************
+ * Constructor / Destructor
+****************************************************************************/
+
+
+/**
+ * Creates one deque per worker and starts the worker threads.
+ * @param threads: Number of workers, 0 for one per hardware thread
+*/
+ThreadPool::ThreadPool(int threads) : queued(0), pending(0), nextQueue(0), stopping(false)
+{
+    if (threads <= 0)
+        threads = thread::hardware_concurrency();
+    if (threads <= 0)
+        threads = 1;
+
+    for (int i = 0; i < threads; i++)
+        queues.push_back(new WorkerQueue());
+    for (int i = 0; i < threads; i++)
+        workers.push_back(thread(&ThreadPool::workerLoop, this, i));
+}
+
+/**
+ * Finishes the outstanding work, then stops and joins every worker.
+*/
+ThreadPool::~ThreadPool()
+{
+    wait();
+    {
+        lock_guard<mutex> guard(idleLock);
+        stopping = true;
+    }
+    idleCond.notify_all();
+    for (int i = 0; i < (int)workers.size(); i++)
+        workers[i].join();
+    for (int i = 0; i < (int)queues.size(); i++)
+        delete queues[i];
+}
+
+
+/**************************************************************************
+ * Scheduling
+****************************************************************************/
+
+/**
+ * Returns the number of worker threads.
+ * @return The number of workers.
+*/
+int ThreadPool::size()
+{
+    return workers.size();
+}
+
+/**
+ * Returns the index of the worker running the calling thread.
+ * @return The worker index, or -1 outside this pool, including on a worker of another pool.
+*/
+int ThreadPool::workerIndex()
+{
+    return currentPool == this ? currentWorker : -1;
+}
+
+/**
+ * Puts a task on a deque and wakes one sleeping worker.
+ * @param task The task to run.
+*/
+void ThreadPool::submit(function<void()> task)
+{
+    int index = workerIndex();
+    if (index < 0)
+        index = nextQueue++ % queues.size();
+
+    pending++;
+    {
+        lock_guard<mutex> guard(queues[index]->lock);
+        queues[index]->tasks.push_back(move(task));
+    }
+    {
+        lock_guard<mutex> guard(idleLock);
+        queued++;
+    }
+    idleCond.notify_one();
+}
+
+/**
+ * Looks for a task: newest first on the worker's own deque, then oldest first on every other deque.
+ * @param index The worker looking for work, or -1 for an outside thread, which only takes oldest first.
+ * @param task Receives the task.
+ * @return True if a task was found.
+*/
+bool ThreadPool::takeTask(int index, function<void()> &task)
+{
+    int count = queues.size();
+    int first = index < 0 ? 0 : index;
+    for (int i = 0; i < count; i++)
+    {
+        WorkerQueue* queue = queues[(first + i) % count];
+        lock_guard<mutex> guard(queue->lock);
+        if (queue->tasks.empty())
+            continue;
+
+        if (i == 0 && index >= 0)
+        {
+            task = move(queue->tasks.back());
+            queue->tasks.pop_back();
+        }
+        else
+        {
+            task = move(queue->tasks.front());
+            queue->tasks.pop_front();
+        }
+        queued--;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Runs a task and wakes anyone waiting in wait() once the last pending task is done.
+ * @param task The task to run.
+*/
+void ThreadPool::runTask(function<void()> &task)
+{
+    task();
+    task = nullptr;
+    if (--pending == 0)
+    {
+        lock_guard<mutex> guard(doneLock);
+        doneCond.notify_all();
+    }
+}
+
+/**
+ * Worker thread body: run tasks until the pool is stopped, sleeping while every deque is empty.
+ * @param index The index of the worker.
+*/
+void ThreadPool::workerLoop(int index)
+{
+    currentPool = this;
+    currentWorker = index;
+    function<void()> task;
+    while (true)
+    {
+        if (takeTask(index, task))
+        {
+            runTask(task);
+            continue;
+        }
+
+        unique_lock<mutex> guard(idleLock);
+        idleCond.wait(guard, [this] { return stopping || queued > 0; });
+        if (stopping && queued == 0)
+            return;
+    }
+}
+
+/**
+ * Runs queued tasks on the calling thread until finished() returns true. A worker of this pool takes the
+ * newest task of its own deque first, as in workerLoop; any other thread, including a worker of another
+ * pool, only takes the oldest task of each deque, so it never competes with a worker's own end. Yields when
+ * there is nothing to run.
+ * @param finished Returns true once the caller can continue.
+*/
+void ThreadPool::runUntil(function<bool()> finished)
+{
+    int index = workerIndex();
+
+    function<void()> task;
+    while (!finished())
+    {
+        if (takeTask(index, task))
+            runTask(task);
+        else
+            this_thread::yield();
+    }
+}
+
+/**
+ * Waits for every submitted task. Must be called from outside the pool.
+*/
+void ThreadPool::wait()
+{
+    unique_lock<mutex> guard(doneLock);
+    doneCond.wait(guard, [this] { return pending == 0; });
+}
@@ -0,0 +1,113 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author          :Ajinkya Joshi, Anthony Chamoun
+* Date            :March 15th, 2023
+* File name       :ThreadPool.h
+* Purpose         :Work-stealing thread pool used to spread puzzles
+*                  across cores.
+ **************************************************************************/
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+using namespace std;
+
+class ThreadPool
+{
+
+/*
+ * Every worker owns a deque of tasks. A worker takes work from the back of its own deque and, when that is
+ * empty, steals from the front of the other workers' deques. Tasks submitted from outside the pool are dealt
+ * round-robin; tasks submitted by a worker go onto that worker's own deque. A worker of another pool counts
+ * as outside.
+*/
+private:
+    struct WorkerQueue
+    {
+        mutex lock;
+        deque<function<void()>> tasks;
+    };
+
+    vector<thread> workers;
+    vector<WorkerQueue*> queues;
+    mutex idleLock; // guards queued and stopping for sleeping workers
+    condition_variable idleCond; // signalled when work arrives or the pool stops
+    mutex doneLock;
+    condition_variable doneCond; // signalled when pending drops to zero
+    atomic<int> queued; // tasks sitting in a deque
+    atomic<int> pending; // tasks submitted and not yet finished
+    atomic<unsigned int> nextQueue; // round-robin position for outside submissions
+    bool stopping;
+
+    /**
+    * Main loop of a worker thread.
+    * @param index The index of the worker.
+    */
+    void workerLoop(int index);
+
+    /**
+    * Takes a task from a worker's own deque or steals one from another worker.
+    * @param index The index of the worker looking for work.
+    * @param task Receives the task.
+    * @return True if a task was found.
+    */
+    bool takeTask(int index, function<void()> &task);
+
+    /**
+    * Runs a task and updates the pending count.
+    * @param task The task to run.
+    */
+    void runTask(function<void()> &task);
+
+public:
+
+    /**
+    * Starts the worker threads.
+    * @param threads Number of workers. 0 uses one worker per hardware thread.
+    */
+    ThreadPool(int threads = 0);
+
+    /**
+    * Waits for all submitted tasks and joins the workers.
+    */
+    ~ThreadPool();
+
+    /**
+    * Returns the number of worker threads.
+    * @return The number of workers.
+    */
+    int size();
+
+    /**
+    * Queues a task for execution.
+    * @param task The task to run.
+    */
+    void submit(function<void()> task);
+
+    /**
+    * Blocks until every submitted task has finished. Must not be called from a worker thread.
+    */
+    void wait();
+
+    /**
+    * Keeps the calling thread busy running queued tasks until a condition holds. Unlike wait, this may be
+    * called from inside a task, e.g. to wait for the subtasks it submitted.
+    * @param finished Returns true once the caller can continue.
+    */
+    void runUntil(function<bool()> finished);
+
+    /**
+    * Returns the index of the worker running the calling thread in this pool.
+    * @return The worker index, or -1 when called from outside the pool, including from another pool's worker.
+    */
+    int workerIndex();
+};
+
+#endif
@@ -0,0 +1,787 @@
+/**************************************************************************
+* Project 1 TEAM 2
+* author          :Ajinkya Joshi, Anthony Chamoun
+* Date            :March 15th, 2023
+* File name       :main.cpp
+* Purpose         :Solve sudoku boards
+ **************************************************************************/
+
+#include <fstream>
+#include <iostream>
+#include "SudokuBoard.h"
+#include "DancingLinks.h"
+#include "BatchSolver.h"
+#include "PuzzleFile.h"
+#include "OutputWriter.h"
+#include "SolverServer.h"
+#include "PuzzleGrader.h"
+#include "PackedCorpus.h"
+#include <algorithm>
+#include <vector>
+#include <cstring>
+#include <cstdlib>
+#include <climits>
+
+using namespace std;
+
+/**
+ * Running minimum, maximum, average and histogram of a count, kept without storing every value so that a
+ * stream of any length is summarized in constant memory. Bucket 0 counts zeros and bucket k the values from
+ * 2^(k-1) to 2^k - 1.
+*/
+struct CallStats
+{
+    static const int Buckets = 33;
+
+    int minimum = INT_MAX;
+    int maximum = INT_MIN;
+    double total = 0;
+    long long count = 0;
+    long long histogram[Buckets] = {};
+
+    /**
+     * Adds one value.
+     * @param value the count of one board
+    */
+    void add(int value)
+    {
+        minimum = min(minimum, value);
+        maximum = max(maximum, value);
+        total += value;
+        count++;
+        histogram[value <= 0 ? 0 : 32 - __builtin_clz(value)]++;
+    }
+
+    /**
+     * Prints the non-empty buckets on one line, e.g. "0: 3, 1: 5, 2-3: 10, 4-7: 2".
+     * @param out the output writer
+    */
+    void printHistogram(OutputWriter& out)
+    {
+        bool first = true;
+        for (int k = 0; k < Buckets; k++)
+        {
+            if (histogram[k] == 0)
+                continue;
+            long long low = k == 0 ? 0 : 1LL << (k - 1), high = k == 0 ? 0 : (1LL << k) - 1;
+            out << (first ? "" : ", ") << low;
+            if (high > low)
+                out << '-' << high;
+            out << ": " << histogram[k];
+            first = false;
+        }
+        out << '\n';
+    }
+};
+
+
+/**
+ * Prints a freshly loaded puzzle and its initial conflicts.
+ * @param sdk the board holding the puzzle
+ * @param out the output writer
+*/
+static void printPuzzle(SudokuBoard* sdk, OutputWriter& out)
+{
+    // Print sudoku
+    out << "\n***** NEW SUDOKU PUZZLE... ******\n";
+
+    sdk->printSudoku(out); // print the board on the terminal and the file
+    // ******** Evaluate and print conflicts *****
+    // If found, print out the resulting solution and final conflicts
+
+    // finds and prints initial conflicts of the board
+    sdk->setConflict();
+    sdk->printConflict(out);
+}
+
+/**
+ * Computes the search speed of one puzzle.
+ * @param result the outcome of the solve
+ * @return the nodes visited per second of solve time, 0 if no time was measured
+*/
+static long long nodesPerSecond(PuzzleResult& result)
+{
+    if (result.nanos <= 0)
+        return 0;
+    return (long long)(result.recursiveCount * 1e9 / result.nanos);
+}
+
+/**
+ * Prints the outcome of one puzzle. The board must hold the solved state.
+ * @param sdk the board holding the solution
+ * @param out the output writer
+ * @param result the outcome of the solve
+ * @param showPropagation true to print the propagation counters
+*/
+static void printResult(SudokuBoard* sdk, OutputWriter& out, PuzzleResult& result, bool showPropagation)
+{
+    if (result.gaveUp)
+    {
+        /* The budget ran out before an answer either way; a count cut short has only a lower bound, even
+         * when it found a solution */
+        out << "\nGave Up After " << result.recursiveCount - 1 << " Recursive Calls And "
+            << result.backtracksCount << " Backtracks...!\n";
+        if (result.solutions > 0)
+            out << "Solutions found: at least " << (long long)result.solutions << ", budget exhausted\n";
+        out << "\nIncomplete board ...\n";
+    }
+
+    else if (result.solved)
+    {
+        /* Print completed board
+          * print the conflicts
+          * print # of recursive calls
+          * print # of backtrack calls
+          * */
+        out << "\nComplete Solution Found.\n";
+        out << "\nCompleted board ...\n";
+        sdk -> printSudoku(out);
+
+        out << "Recursive calls: " << result.recursiveCount - 1 << '\n';
+        out << "Backtracks: " << result.backtracksCount << '\n';
+
+        if (result.cached)
+            out << "Solution taken from the cache\n";
+        if (result.solutions >= 0)
+            out << "Solutions found: " << (long long)result.solutions << (result.solutions > 1 ? " (not unique)" : "") << '\n';
+
+        PropagationStats prop = result.propagation;
+        if (showPropagation && prop.nakedSingles + prop.hiddenSingles + prop.lockedEliminations > 0)
+        {
+            out << "Naked singles: " << prop.nakedSingles << '\n';
+            out << "Hidden singles: " << prop.hiddenSingles << '\n';
+            out << "Locked candidate eliminations: " << prop.lockedEliminations << '\n';
+        }
+
+        // only measured in builds with -DSUDOKU_PROFILE
+        SearchProfile profile = result.profile;
+        if (ProfileEnabled && !result.cached)
+        {
+            out << "Nodes per second: " << nodesPerSecond(result) << '\n';
+            out << "Maximum depth: " << profile.maxDepth << '\n';
+            out << "Time selecting cells (ns): " << profile.selectNanos << '\n';
+            out << "Time computing candidates (ns): " << profile.candidateNanos << '\n';
+            out << "Time propagating (ns): " << profile.propagateNanos << '\n';
+            if (profile.cycles >= 0)
+                out << "Cycles: " << profile.cycles << ", instructions: " << profile.instructions
+                    << ", branch misses: " << profile.branchMisses << '\n';
+        }
+    }
+
+    else {
+        /* Print incompleted board */
+        out << "\nNo Solution Found...!\n";
+        out << "\nIncomplete board ...\n";
+    }
+}
+
+/**
+ * Prints the header line of the structured output modes.
+ * @param out the output writer
+ * @param mode the output mode
+*/
+static void printHeader(OutputWriter& out, OutputMode mode)
+{
+    if (mode == Csv)
+    {
+        out << "index,solved,recursive_calls,backtracks,naked_singles,hidden_singles,locked_eliminations,"
+               "solve_ns,solutions,cached,gave_up,";
+        if (ProfileEnabled)
+            out << "nodes_per_sec,max_depth,select_ns,candidate_ns,propagate_ns,cycles,instructions,branch_misses,";
+        out << "solution\n";
+    }
+}
+
+/**
+ * Prints the one-line record of a puzzle in the compact and structured output modes.
+ * @param out the output writer
+ * @param mode Compact, Csv or JsonLines
+ * @param index the position of the puzzle in the input file
+ * @param result the outcome of the solve
+*/
+static void printRecord(OutputWriter& out, OutputMode mode, long long index, PuzzleResult& result)
+{
+    PropagationStats prop = result.propagation;
+    if (mode == Compact)
+    {
+        out << result.solution << '\n';
+    }
+    else if (mode == Csv)
+    {
+        out << index << ',' << (result.solved ? "1" : "0") << ',' << result.recursiveCount - 1 << ','
+            << result.backtracksCount << ',' << prop.nakedSingles << ',' << prop.hiddenSingles << ','
+            << prop.lockedEliminations << ',' << result.nanos << ',';
+        // only known when counting, left empty otherwise like null in the JSON records
+        if (result.solutions >= 0)
+            out << (long long)result.solutions;
+        out << ',' << (result.cached ? "1" : "0") << ',' << (result.gaveUp ? "1" : "0") << ',';
+        if (ProfileEnabled)
+        {
+            SearchProfile profile = result.profile;
+            out << nodesPerSecond(result) << ',' << profile.maxDepth << ',' << profile.selectNanos << ','
+                << profile.candidateNanos << ',' << profile.propagateNanos << ',' << profile.cycles << ','
+                << profile.instructions << ',' << profile.branchMisses << ',';
+        }
+        out << result.solution << '\n';
+    }
+    else if (mode == JsonLines)
+    {
+        out << "{\"index\":" << index << ",\"solved\":" << (result.solved ? "true" : "false")
+            << ",\"recursive_calls\":" << result.recursiveCount - 1 << ",\"backtracks\":" << result.backtracksCount
+            << ",\"naked_singles\":" << prop.nakedSingles << ",\"hidden_singles\":" << prop.hiddenSingles
+            << ",\"locked_eliminations\":" << prop.lockedEliminations << ",\"solve_ns\":" << result.nanos
+            << ",\"solutions\":";
+        // only known when counting
+        if (result.solutions >= 0)
+            out << (long long)result.solutions;
+        else
+            out << "null";
+        out << ",\"cached\":" << (result.cached ? "true" : "false");
+        out << ",\"gave_up\":" << (result.gaveUp ? "true" : "false");
+        if (ProfileEnabled)
+        {
+            SearchProfile profile = result.profile;
+            out << ",\"nodes_per_sec\":" << nodesPerSecond(result) << ",\"max_depth\":" << profile.maxDepth
+                << ",\"select_ns\":" << profile.selectNanos << ",\"candidate_ns\":" << profile.candidateNanos
+                << ",\"propagate_ns\":" << profile.propagateNanos << ",\"cycles\":" << profile.cycles
+                << ",\"instructions\":" << profile.instructions << ",\"branch_misses\":" << profile.branchMisses;
+        }
+        out << ",\"solution\":\"" << result.solution << "\"}\n";
+    }
+}
+
+/**
+ * Grades every puzzle of the file by the techniques it needs instead of solving it, and prints one record
+ * per puzzle in the requested mode followed, in the full and quiet modes, by the number of puzzles per
+ * hardest technique.
+ * @param fin the puzzle file
+ * @param sdk the board to grade on
+ * @param out the output writer
+ * @param mode the output mode
+*/
+static void gradeFile(PuzzleFile& fin, SudokuBoard* sdk, OutputWriter& out, OutputMode mode)
+{
+    PuzzleGrader grader(sdk->getBoardSize());
+    vector<int> hardest(TechniqueCount, 0);
+    int invalid = 0;
+
+    if (mode == Csv)
+    {
+        out << "index,valid,solved,hardest,score";
+        for (int t = 0; t < TechniqueCount; t++)
+            out << ',' << PuzzleGrader::techniqueName((Technique)t);
+        out << '\n';
+    }
+    for (int index = 0; index < fin.size(); index++)
+    {
+        fin.load(index, *sdk);
+        if (mode == Full)
+            printPuzzle(sdk, out);
+        PuzzleGrade grade = grader.gradeBoard(*sdk);
+        if (grade.valid)
+            hardest[grade.hardest]++;
+        else
+            invalid++;
+
+        const char* name = PuzzleGrader::techniqueName(grade.hardest);
+        if (mode == Full)
+        {
+            if (!grade.valid)
+                out << "\nThe clues contradict each other.\n";
+            else
+            {
+                out << "\nHardest technique: " << name << '\n';
+                out << "Score: " << grade.score << '\n';
+                for (int t = 0; t < TechniqueCount; t++)
+                    if (grade.uses[t] > 0)
+                        out << PuzzleGrader::techniqueName((Technique)t) << ": " << grade.uses[t] << '\n';
+            }
+            if (!grade.solved)
+            {
+                out << "\nBoard when the techniques ran out ...\n";
+                sdk->printSudoku(out);
+            }
+        }
+        else if (mode == Compact)
+            out << (grade.valid ? name : "invalid") << ' ' << grade.score << '\n';
+        else if (mode == Csv)
+        {
+            out << index << ',' << (grade.valid ? "1" : "0") << ',' << (grade.solved ? "1" : "0") << ',' << name
+                << ',' << grade.score;
+            for (int t = 0; t < TechniqueCount; t++)
+                out << ',' << grade.uses[t];
+            out << '\n';
+        }
+        else if (mode == JsonLines)
+        {
+            out << "{\"index\":" << index << ",\"valid\":" << (grade.valid ? "true" : "false") << ",\"solved\":"
+                << (grade.solved ? "true" : "false") << ",\"hardest\":\"" << name << "\",\"score\":" << grade.score
+                << ",\"uses\":{";
+            for (int t = 0; t < TechniqueCount; t++)
+                out << (t > 0 ? "," : "") << '"' << PuzzleGrader::techniqueName((Technique)t) << "\":" << grade.uses[t];
+            out << "}}\n";
+        }
+    }
+
+    if (mode == Full || mode == Quiet)
+    {
+        out << "\nNumber of boards graded: " << fin.size() << '\n';
+        for (int t = 0; t < TechniqueCount; t++)
+            if (hardest[t] > 0)
+                out << "Hardest technique " << PuzzleGrader::techniqueName((Technique)t) << ": " << hardest[t] << '\n';
+        if (invalid > 0)
+            out << "Boards with contradicting clues: " << invalid << '\n';
+    }
+}
+
+/**
+ * Copies every puzzle of the input, text or packed, into a packed file without solving it. Solutions and
+ * counters stored in a packed input are carried over.
+ * @param fin the input file
+ * @param path the packed file to write
+ * @param boardSize the size of the boards
+ * @return false if the file could not be written
+*/
+static bool packFile(PuzzleFile& fin, const string& path, int boardSize)
+{
+    string solution;
+    PackedStats stats;
+    bool solutions = fin.size() > 0 && fin.storedSolution(0, solution);
+    bool counters = fin.size() > 0 && fin.storedStats(0, stats);
+    PackedWriter packer;
+    if (!packer.open(path, boardSize, (solutions ? PackedHasSolutions : 0) | (counters ? PackedHasStats : 0)))
+        return false;
+    for (int index = 0; index < fin.size(); index++)
+    {
+        fin.storedSolution(index, solution);
+        fin.storedStats(index, stats);
+        packer.write(fin.text(index), solution, stats);
+    }
+    return packer.close();
+}
+
+/**
+ * Writes every puzzle of the input as one line, followed by its stored solution when the input is a packed
+ * file that keeps them, as the generator does with --solutions.
+ * @param fin the input file
+ * @param path the text file to write
+ * @return false if the file could not be written
+*/
+static bool unpackFile(PuzzleFile& fin, const string& path)
+{
+    OutputWriter out;
+    if (!out.open(path))
+        return false;
+    out.echo(false);
+    string solution;
+    for (int index = 0; index < fin.size(); index++)
+    {
+        out << fin.text(index);
+        if (fin.storedSolution(index, solution))
+            out << ' ' << solution;
+        out << '\n';
+    }
+    out.flush();
+    return true;
+}
+
+/**
+ * Picks what a packed file keeps as the solution of a puzzle: the board only when it was solved, since an
+ * unsolved board still holds the puzzle and would pass for its own solution.
+ * @param result the outcome of the solve
+ * @return the solution, empty if there is none
+*/
+static string packedSolution(PuzzleResult& result)
+{
+    return result.solved ? result.solution : string();
+}
+
+/**
+ * Copies the counters of a solve into the form a packed file keeps.
+ * @param result the outcome of the solve
+ * @return the counters
+*/
+static PackedStats packedStats(PuzzleResult& result)
+{
+    PackedStats stats;
+    stats.solved = result.solved;
+    stats.gaveUp = result.gaveUp;
+    stats.recursiveCount = result.recursiveCount;
+    stats.backtracksCount = result.backtracksCount;
+    stats.nanos = result.nanos;
+    return stats;
+}
+
+
+int main(int argc, char* argv[]) {
+    int boardCount = 0; // # of Boards from file
+    int boardSize = 9;
+    int solved = 0; // # of boards solved
+    int nosolve = 0; // # of boards not solved
+    int gaveUp = 0; // # of boards whose search ran out of budget
+    int threads = -1; // worker threads for batch mode, -1 solves on this thread
+    OutputMode mode = Full;
+    bool echo = true; // copy the output to the console
+
+    CallStats recur;
+    CallStats backtr;
+
+    SolverOptions options;
+    bool useCache = false;
+    string cacheFile; // where the cache is kept between runs, empty for memory only
+    string inputPath = "/Users/ajinkyajoshi/CLionProjects/algo_project_2/Sudoku3Puzzles.txt";
+    string outputPath = "/Users/ajinkyajoshi/CLionProjects/algo_project_2/Output.txt";
+    string servePath; // socket to answer puzzles on, "-" for stdin and stdout, empty to solve a file
+    bool grade = false; // rate the puzzles by solving technique instead of solving them
+    string packPath; // packed copy of the input to write instead of solving
+    string unpackPath; // text copy of the input to write instead of solving
+    string resultsPath; // packed file receiving every puzzle with its solution and counters
+
+    // "--mrv" branches on the most constrained cell instead of the first blank
+    // "--dlx" solves with dancing links instead of solveSudoku
+    // "--propagate" applies singles and locked candidates at every node of solveSudoku
+    // "--threads N" solves the whole file on N worker threads (0 = all cores)
+    // "--split D" splits each puzzle's search tree D levels deep across the threads
+    //             (all cores when --threads is not given, puzzles then run one at a time)
+    // "--size N" solves N x N boards (4, 9, 16, 25 or 36)
+    // "--output MODE" full (default), quiet (summary only), compact (one board per line),
+    //                 csv or json (one record per puzzle with its counters and solve time)
+    // "--no-echo" writes the output file only, not the console
+    // "--count L" counts solutions up to L instead of stopping at the first (never split)
+    // "--unique" checks that every puzzle has exactly one solution, same as --count 2
+    // "--lockstep" propagates 9 x 9 puzzles 16 at a time with vector instructions, searching only
+    //              those left unfinished (batch mode, one thread unless --threads is given)
+    // "--cache" solves a puzzle equal up to symmetry to one solved before from the earlier solution
+    // "--cache-file FILE" also reads the cache from FILE at the start and writes it back at the end
+    // "--max-nodes N", "--max-backtracks N" and "--max-ms T" give up on a puzzle whose search goes past
+    //                N recursive calls, N backtracks or T milliseconds; refused with --dlx or --split
+    // "--grade" rates every puzzle by the hardest human technique it needs instead of solving it
+    // "--input FILE" and "--out-file FILE" replace the default puzzle and output files; "--input -" streams
+    //                one-line puzzles from stdin in constant memory (all cores unless --threads is given,
+    //                never with --split)
+    //                and "--out-file -" writes to stdout only
+    // "--serve PATH" keeps running and answers one-line puzzles sent to the Unix socket PATH, or on stdin
+    //                and stdout when PATH is "-" (all cores unless --threads is given)
+    // "--pack FILE" copies the input puzzles into the packed binary format and stops; a packed input is read
+    //               like any puzzle file, with random access to every puzzle
+    // "--unpack FILE" writes the input puzzles one per line, each followed by its stored solution, and stops
+    // "--pack-results FILE" solves as usual and also writes every puzzle, its solution and counters, packed
+    // built with -DSUDOKU_PROFILE, the full, csv and json outputs also show where each search spent its time
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--mrv") == 0)
+            options.selection = MinRemaining;
+        else if (strcmp(argv[i], "--dlx") == 0)
+            options.useDlx = true;
+        else if (strcmp(argv[i], "--propagate") == 0)
+            options.propagate = true;
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--split") == 0 && i + 1 < argc)
+            options.splitDepth = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+            boardSize = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--no-echo") == 0)
+            echo = false;
+        else if (strcmp(argv[i], "--count") == 0 && i + 1 < argc)
+            options.countLimit = atol(argv[++i]);
+        else if (strcmp(argv[i], "--unique") == 0)
+            options.countLimit = 2;
+        else if (strcmp(argv[i], "--lockstep") == 0)
+            options.lockstep = true;
+        else if (strcmp(argv[i], "--cache") == 0)
+            useCache = true;
+        else if (strcmp(argv[i], "--max-nodes") == 0 && i + 1 < argc)
+            options.budget.nodes = atol(argv[++i]);
+        else if (strcmp(argv[i], "--max-backtracks") == 0 && i + 1 < argc)
+            options.budget.backtracks = atol(argv[++i]);
+        else if (strcmp(argv[i], "--max-ms") == 0 && i + 1 < argc)
+            options.budget.nanos = (long long)(atof(argv[++i]) * 1e6);
+        else if (strcmp(argv[i], "--grade") == 0)
+            grade = true;
+        else if (strcmp(argv[i], "--input") == 0 && i + 1 < argc)
+            inputPath = argv[++i];
+        else if (strcmp(argv[i], "--out-file") == 0 && i + 1 < argc)
+            outputPath = argv[++i];
+        else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc)
+            servePath = argv[++i];
+        else if (strcmp(argv[i], "--pack") == 0 && i + 1 < argc)
+            packPath = argv[++i];
+        else if (strcmp(argv[i], "--unpack") == 0 && i + 1 < argc)
+            unpackPath = argv[++i];
+        else if (strcmp(argv[i], "--pack-results") == 0 && i + 1 < argc)
+            resultsPath = argv[++i];
+        else if (strcmp(argv[i], "--cache-file") == 0 && i + 1 < argc)
+        {
+            useCache = true;
+            cacheFile = argv[++i];
+        }
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+        {
+            const char* name = argv[++i];
+            if (strcmp(name, "full") == 0)
+                mode = Full;
+            else if (strcmp(name, "quiet") == 0)
+                mode = Quiet;
+            else if (strcmp(name, "compact") == 0)
+                mode = Compact;
+            else if (strcmp(name, "csv") == 0)
+                mode = Csv;
+            else if (strcmp(name, "json") == 0)
+                mode = JsonLines;
+            else
+            {
+                cerr << "Unknown output mode " << name << endl;
+                exit(1);
+            }
+        }
+    }
+    if (options.lockstep && threads < 0)
+        threads = 1;
+    if (!SudokuBoard::supportedSize(boardSize))
+    {
+        cerr << "Unsupported board size " << boardSize << endl;
+        exit(1);
+    }
+
+    // neither dancing links nor the split search checks a budget, so a budget there would silently not hold,
+    // in server mode as much as for files
+    bool budgeted = options.budget.nodes > 0 || options.budget.backtracks > 0 || options.budget.nanos > 0;
+    if (budgeted && (options.useDlx || options.splitDepth > 0))
+    {
+        cerr << "--max-nodes, --max-backtracks and --max-ms cannot be used with --dlx or --split" << endl;
+        exit(1);
+    }
+
+    // Create SudokuBoard object
+    SudokuBoard* sdk = new SudokuBoard(boardSize);
+    sdk->setSelection(options.selection);
+    sdk->setPropagation(options.propagate);
+    DancingLinks* dlx = options.useDlx ? new DancingLinks(boardSize) : NULL;
+    SolutionCache* cache = useCache ? new SolutionCache() : NULL;
+    if (cache != NULL && !cacheFile.empty() && !cache->load(cacheFile))
+        cerr << "Cannot read cache file " << cacheFile << endl;
+    options.cache = cache;
+
+    // Server mode: no files, puzzles come in one line at a time until the input or the socket closes
+    if (!servePath.empty())
+    {
+        BatchSolver batch(max(threads, 0), boardSize, options);
+        SolverServer server(batch, boardSize, options);
+        if (servePath == "-")
+            server.serveStream(0, 1);
+        else if (!server.listenOn(servePath))
+            exit(1);
+        if (cache != NULL && !cacheFile.empty() && !cache->save(cacheFile))
+            cerr << "Cannot write cache file " << cacheFile << endl;
+        delete sdk;
+        delete dlx;
+        delete cache;
+        return 0;
+    }
+
+    // Open the data file and verify it opens successfully
+
+
+    // maps sudoku input file, either the grid format or one puzzle per line; stdin is read as it comes instead
+    bool streaming = inputPath == "-";
+    if (streaming && (grade || !packPath.empty() || !unpackPath.empty()))
+    {
+        cerr << "Grading and converting need an input file" << endl;
+        exit(1);
+    }
+    if (streaming && options.splitDepth > 0)
+    {
+        // the stream holds every worker for its whole length, so split leaves would get no other thread
+        cerr << "--split needs an input file" << endl;
+        exit(1);
+    }
+    PuzzleFile fin(boardSize);
+    if (!streaming && !fin.open(inputPath))
+    {
+        cerr << "Cannot open '" << inputPath << "'" << endl;
+        exit(1);
+    }
+
+    // Conversion modes: the puzzles are copied into another format, not solved
+    if (!packPath.empty() || !unpackPath.empty())
+    {
+        const string& path = !packPath.empty() ? packPath : unpackPath;
+        bool written = !packPath.empty() ? packFile(fin, path, boardSize) : unpackFile(fin, path);
+        if (!written)
+        {
+            cerr << "Cannot write '" << path << "'" << endl;
+            exit(1);
+        }
+        cerr << "Wrote " << fin.size() << " puzzles to " << path << endl;
+        fin.close();
+        delete sdk;
+        delete dlx;
+        delete cache;
+        return 0;
+    }
+    PackedWriter results;
+    if (!resultsPath.empty() && !results.open(resultsPath, boardSize, PackedHasSolutions | PackedHasStats))
+    {
+        cerr << "Cannot open '" << resultsPath << "'" << endl;
+        exit(1);
+    }
+
+    // opens and creates output file, everything printed goes through one buffer
+    OutputWriter out;
+    if (outputPath != "-" && !out.open(outputPath)) {
+        cerr << "Cannot open file << endl";
+        exit(1);
+    }
+    out.echo(echo || outputPath == "-");
+
+    // Grading mode: the puzzles are rated, not solved
+    if (grade)
+    {
+        gradeFile(fin, sdk, out, mode);
+        out.flush();
+        fin.close();
+        delete sdk;
+        delete dlx;
+        delete cache;
+        return 0;
+    }
+    printHeader(out, mode);
+
+    // adds recursive and backtracks to the vectors and counts the board
+    auto tally = [&](PuzzleResult& result) {
+        if (result.gaveUp)
+        {
+            // one more that ran out of budget, neither fully solved nor shown unsolvable; a count cut short
+            // after its first solution proves nothing about uniqueness
+            gaveUp++;
+        }
+        else if (result.solved)
+        {
+            // one more solved
+            solved++;
+            recur.add(result.recursiveCount - 1);
+            backtr.add(result.backtracksCount);
+        }
+        else
+        {
+            // one more not solved
+            nosolve++;
+        }
+    };
+
+    bool streamFailed = false; // stdin had a line too long to be a puzzle
+    if (streaming)
+    {
+        // Stream mode: read, solve and print at the same time, holding a bounded window of puzzles
+        BatchSolver batch(max(threads, 0), boardSize, options);
+        streamFailed = batch.solveStream(0, [&](long long index, const string& puzzle, PuzzleResult& result) {
+            boardCount++;
+            if (mode == Full)
+            {
+                sdk->initializeBoard(puzzle);
+                printPuzzle(sdk, out);
+                sdk->initializeBoard(result.solution);
+                printResult(sdk, out, result, !options.useDlx);
+            }
+            else
+                printRecord(out, mode, index, result);
+            tally(result);
+            if (!resultsPath.empty())
+                results.write(puzzle, packedSolution(result), packedStats(result));
+        }) < 0;
+        if (streamFailed)
+            cerr << "Input line too long, stopped reading" << endl;
+    }
+    else if (threads >= 0)
+    {
+        // Batch mode: solve the boards in parallel and print them back in file order
+        BatchSolver batch(threads, boardSize, options);
+        batch.solveAll(fin, [&](int index, PuzzleResult& result) {
+            boardCount++;
+            if (mode == Full)
+            {
+                fin.load(index, *sdk);
+                printPuzzle(sdk, out);
+                sdk->initializeBoard(result.solution);
+                printResult(sdk, out, result, !options.useDlx);
+            }
+            else
+                printRecord(out, mode, index, result);
+            tally(result);
+            if (!resultsPath.empty())
+                results.write(fin.text(index), packedSolution(result), packedStats(result));
+        });
+    }
+    else
+    {
+        ThreadPool* splitPool = (options.splitDepth > 0) ? new ThreadPool(0) : NULL;
+
+        // Each iterations solves a NEW board from the input file
+        for (int index = 0; index < fin.size(); index++) {
+            boardCount++; // New board to be solved
+            PuzzleResult result;
+
+            fin.load(index, *sdk); // reads Sudoku from file
+            if (mode == Full)
+                printPuzzle(sdk, out);
+            BatchSolver::solveBoard(*sdk, dlx, result, splitPool, options.splitDepth, options.countLimit, cache,
+                                    options.budget);
+            if (mode == Full)
+                printResult(sdk, out, result, !options.useDlx);
+            else
+                printRecord(out, mode, index, result);
+            tally(result);
+            if (!resultsPath.empty())
+                results.write(fin.text(index), packedSolution(result), packedStats(result));
+        }
+        delete splitPool;
+    }
+
+    // ****** Post processing info **********
+    // the record modes print nothing but their records
+    if (mode == Full || mode == Quiet)
+    {
+        out << "Number of boards solved: " << solved << '\n';
+        out << "Number of Boards with no solution: " << nosolve << '\n';
+        if (gaveUp > 0)
+            out << "Number of Boards given up on: " << gaveUp << '\n';
+
+        // calculates and puts into text file recursive and backtrack info
+        if (recur.count > 0)
+        {
+            out << "Minimum # of Recursive calls: " << recur.minimum << '\n';
+            out << "Maximum # of Recursive calls: " << recur.maximum << '\n';
+            out << "Average # of Recursive calls: " << recur.total / recur.count << '\n';
+
+            out << "Minimum # of BackTrack calls: " << backtr.minimum << '\n';
+            out << "Maximum # of BackTrack calls: " << backtr.maximum << '\n';
+            out << "Average # of BackTrack calls: " << backtr.total / backtr.count << '\n';
+
+            out << "Boards by # of Recursive calls: ";
+            recur.printHistogram(out);
+            out << "Boards by # of BackTrack calls: ";
+            backtr.printHistogram(out);
+        }
+        if (cache != NULL)
+            out << "Boards solved from the cache: " << (long long)cache->hitCount() << " of "
+                << (long long)(cache->hitCount() + cache->missCount()) << '\n';
+
+        // over
+        out << "\n***** Solver Terminating... ******\n";
+    }
+
+    // closes file, deletes object and ends program
+    out.flush();
+    if (!resultsPath.empty() && !results.close())
+        cerr << "Cannot write '" << resultsPath << "'" << endl;
+    fin.close();
+    if (cache != NULL && !cacheFile.empty() && !cache->save(cacheFile))
+        cerr << "Cannot write cache file " << cacheFile << endl;
+    delete sdk;
+    delete dlx;
+    delete cache;
+    return streamFailed ? 1 : 0;
+}
+
+